@@ -0,0 +1,291 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Times allocate on workloads with every memory type and quantum, reporting
+// events per second, peak RSS and ns per scheduling decision, optionally
+// comparing them against a saved baseline
+
+#define OPT_STRING ":r:b:o:"
+
+// Number of times each simulation is run by default, keeping the fastest
+#define DEFAULT_REPEATS 3
+
+// Longest workload name kept in results
+#define WORKLOAD_MAX_LENGTH 63
+
+// Initial capacity of a list of results
+#define INITIAL_RESULTS 64
+
+// Memory types and quanta every workload is simulated with
+const char *bench_mems[] = {"infinite", "first-fit", "paged",
+                            "virtual",  "buddy",     "seg-fit"};
+const char *bench_quanta[] = {"1", "2", "3"};
+
+// Struct to hold the measurements of one simulation
+typedef struct bench_result {
+    char workload[WORKLOAD_MAX_LENGTH + 1];
+    char mem[16];
+    int quantum;
+    double seconds;   // Wall clock time of the fastest run
+    size_t events;    // Event lines printed
+    size_t decisions; // Scheduling decisions counted by --stats
+    long rss;         // Peak resident set size in KB
+} bench_result_t;
+
+// Struct for a growable list of results
+typedef struct bench_results {
+    bench_result_t *results;
+    size_t len;
+    size_t cap;
+} bench_results_t;
+
+// Runs allocate once on a workload, filling in the result's measurements
+// Returns 1 if successful, 0 if allocate failed
+int bench_run(char *allocate, char *workload, const char *mem,
+              const char *quantum, bench_result_t *result);
+
+// Adds a result to the end of a list of results
+void results_add(bench_results_t *list, bench_result_t *result);
+
+// Loads saved results from a file into list
+// Returns 1 if successful, 0 if the file can't be read
+int results_load(bench_results_t *list, char *filename);
+
+// Finds the result for the same simulation as result in list
+// Returns NULL if there is none
+bench_result_t *results_find(bench_results_t *list, bench_result_t *result);
+
+// Prints an error message to stderr and exits the process with an error
+void bench_fail(char *process_name);
+
+int main(int argc, char **argv) {
+    int c, repeats = DEFAULT_REPEATS;
+    char *baseline_file = NULL, *save_file = NULL;
+
+    while ((c = getopt(argc, argv, OPT_STRING)) != -1) {
+        switch (c) {
+        case 'r': // Read the number of times to run each simulation
+            repeats = atoi(optarg);
+            if (repeats < 1) {
+                bench_fail(argv[0]);
+            }
+            break;
+
+        case 'b': // Read the baseline to compare against
+            baseline_file = optarg;
+            break;
+
+        case 'o': // Read the file to save results to
+            save_file = optarg;
+            break;
+
+        default: // Not a supported flag
+            bench_fail(argv[0]);
+        }
+    }
+
+    // Needs allocate and at least one workload
+    if (argc - optind < 2) {
+        bench_fail(argv[0]);
+    }
+    char *allocate = argv[optind];
+
+    bench_results_t baseline = {NULL, 0, 0};
+    if (baseline_file && !results_load(&baseline, baseline_file)) {
+        fprintf(stderr, "%s: no baseline at %s, not comparing\n", argv[0],
+                baseline_file);
+    }
+    bench_results_t results = {NULL, 0, 0};
+
+    printf("%-20s %-10s %2s %10s %12s %10s %12s %9s\n", "workload", "memory",
+           "q", "seconds", "events/s", "peak-KB", "ns/decision", "baseline");
+
+    for (int w = optind + 1; w < argc; w++) {
+        for (size_t m = 0; m < sizeof(bench_mems) / sizeof(*bench_mems); m++) {
+            for (size_t q = 0; q < sizeof(bench_quanta) / sizeof(*bench_quanta);
+                 q++) {
+                bench_result_t best, run;
+                best.seconds = -1;
+
+                for (int r = 0; r < repeats; r++) {
+                    if (!bench_run(allocate, argv[w], bench_mems[m],
+                                   bench_quanta[q], &run)) {
+                        fprintf(stderr, "%s: %s failed on %s -m %s -q %s\n",
+                                argv[0], allocate, argv[w], bench_mems[m],
+                                bench_quanta[q]);
+                        exit(EXIT_FAILURE);
+                    }
+                    if (best.seconds < 0 || run.seconds < best.seconds) {
+                        best = run;
+                    }
+                }
+                results_add(&results, &best);
+
+                double per_decision =
+                    best.decisions ? best.seconds * 1e9 / best.decisions : 0;
+                printf("%-20s %-10s %2d %10.4f %12.0f %10ld %12.1f ",
+                       best.workload, best.mem, best.quantum, best.seconds,
+                       best.seconds > 0 ? best.events / best.seconds : 0,
+                       best.rss, per_decision);
+
+                // Compare time per decision, which doesn't depend on how many
+                // decisions the workload needs
+                bench_result_t *base = results_find(&baseline, &best);
+                if (base && base->decisions && per_decision > 0) {
+                    double base_per_decision =
+                        base->seconds * 1e9 / base->decisions;
+                    printf("%+8.1f%%\n",
+                           (per_decision / base_per_decision - 1) * 100);
+                } else {
+                    printf("%9s\n", "-");
+                }
+                fflush(stdout);
+            }
+        }
+    }
+
+    if (save_file) {
+        FILE *f = fopen(save_file, "w");
+        if (!f) {
+            fprintf(stderr, "%s: cannot write %s\n", argv[0], save_file);
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < results.len; i++) {
+            bench_result_t *r = &results.results[i];
+            fprintf(f, "%s %s %d %.9f %zu %zu %ld\n", r->workload, r->mem,
+                    r->quantum, r->seconds, r->events, r->decisions, r->rss);
+        }
+        fclose(f);
+    }
+
+    free(results.results);
+    free(baseline.results);
+    exit(EXIT_SUCCESS);
+}
+
+// Runs allocate once on a workload, filling in the result's measurements
+// Returns 1 if successful, 0 if allocate failed
+int bench_run(char *allocate, char *workload, const char *mem,
+              const char *quantum, bench_result_t *result) {
+    // Results are keyed by the workload's file name, so baselines still
+    // match when run from elsewhere
+    const char *name = strrchr(workload, '/');
+    name = name ? name + 1 : workload;
+    snprintf(result->workload, sizeof(result->workload), "%s", name);
+    snprintf(result->mem, sizeof(result->mem), "%s", mem);
+    result->quantum = atoi(quantum);
+    result->events = 0;
+    result->decisions = 0;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return 0;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        return 0;
+    }
+    if (pid == 0) {
+        // Simulate with allocate's output going to the pipe
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execl(allocate, allocate, "-f", workload, "-m", mem, "-q", quantum,
+              "--stats", (char *)NULL);
+        _exit(EXIT_FAILURE);
+    }
+    close(fds[1]);
+
+    // Events are the lines starting with their time, the summary's don't
+    FILE *out = fdopen(fds[0], "r");
+    assert(out);
+    char *line = NULL;
+    size_t line_cap = 0;
+    while (getline(&line, &line_cap, out) != -1) {
+        if (line[0] >= '0' && line[0] <= '9') {
+            result->events++;
+        } else {
+            sscanf(line, "Stat decisions %zu", &result->decisions);
+        }
+    }
+    free(line);
+    fclose(out);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid) {
+        return 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    result->seconds =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    result->rss = usage.ru_maxrss;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+// Adds a result to the end of a list of results
+void results_add(bench_results_t *list, bench_result_t *result) {
+    if (list->len >= list->cap) {
+        list->cap = list->cap ? list->cap * 2 : INITIAL_RESULTS;
+        list->results =
+            realloc(list->results, sizeof(*list->results) * list->cap);
+        assert(list->results);
+    }
+
+    list->results[list->len++] = *result;
+}
+
+// Loads saved results from a file into list
+// Returns 1 if successful, 0 if the file can't be read
+int results_load(bench_results_t *list, char *filename) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        return 0;
+    }
+
+    bench_result_t r;
+    while (fscanf(f, "%63s %15s %d %lf %zu %zu %ld", r.workload, r.mem,
+                  &r.quantum, &r.seconds, &r.events, &r.decisions,
+                  &r.rss) == 7) {
+        results_add(list, &r);
+    }
+
+    fclose(f);
+    return 1;
+}
+
+// Finds the result for the same simulation as result in list
+// Returns NULL if there is none
+bench_result_t *results_find(bench_results_t *list, bench_result_t *result) {
+    for (size_t i = 0; i < list->len; i++) {
+        bench_result_t *r = &list->results[i];
+        if (strcmp(r->workload, result->workload) == 0 &&
+            strcmp(r->mem, result->mem) == 0 &&
+            r->quantum == result->quantum) {
+            return r;
+        }
+    }
+
+    return NULL;
+}
+
+// Prints an error message to stderr and exits the process with an error
+void bench_fail(char *process_name) {
+    fprintf(stderr,
+            "Usage: %s [-r <repeats>] [-b <baseline file>] "
+            "[-o <results file>] <allocate> <workload>...\n",
+            process_name);
+    exit(EXIT_FAILURE);
+}
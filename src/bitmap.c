@@ -0,0 +1,137 @@
+#include "bitmap.h"
+#include "stats.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WORD(i) ((i) / BITMAP_WORD_BITS)
+#define BIT(i) ((uint64_t)1 << ((i) % BITMAP_WORD_BITS))
+#define FULL_WORD (~(uint64_t)0)
+
+// Finds the lowest word that still has a cleared bit
+// Returns n_words if every word is full
+size_t first_free_word(bitmap_t *b);
+
+// Creates and returns a new bitmap of n_bits cleared bits
+bitmap_t *new_bitmap(size_t n_bits) {
+    bitmap_t *b = malloc(sizeof(*b));
+    assert(b);
+
+    b->n_bits = n_bits;
+    b->n_words = WORD(n_bits + BITMAP_WORD_BITS - 1);
+    b->n_full_words = WORD(b->n_words + BITMAP_WORD_BITS - 1);
+    b->n_set = 0;
+    b->hint = 0;
+
+    b->words = calloc(b->n_words ? b->n_words : 1, sizeof(*b->words));
+    assert(b->words);
+    b->full = calloc(b->n_full_words ? b->n_full_words : 1, sizeof(*b->full));
+    assert(b->full);
+
+    // Pad the last word with set bits so they are never handed out
+    if (n_bits % BITMAP_WORD_BITS) {
+        b->words[b->n_words - 1] = FULL_WORD << (n_bits % BITMAP_WORD_BITS);
+    }
+
+    // Pad the last summary word so missing words are never searched
+    if (b->n_words % BITMAP_WORD_BITS) {
+        b->full[b->n_full_words - 1] = FULL_WORD
+                                       << (b->n_words % BITMAP_WORD_BITS);
+    }
+
+    return b;
+}
+
+// Returns 1 if the bit at index is set, 0 otherwise
+int bitmap_test(bitmap_t *b, size_t index) {
+    return (b->words[WORD(index)] & BIT(index)) != 0;
+}
+
+// Sets the bit at the provided index
+void bitmap_set(bitmap_t *b, size_t index) {
+    size_t w = WORD(index);
+    if (b->words[w] & BIT(index)) {
+        return;
+    }
+
+    b->words[w] |= BIT(index);
+    b->n_set += 1;
+
+    if (b->words[w] == FULL_WORD) {
+        b->full[WORD(w)] |= BIT(w);
+    }
+}
+
+// Clears the bit at the provided index
+void bitmap_clear(bitmap_t *b, size_t index) {
+    size_t w = WORD(index);
+    if (!(b->words[w] & BIT(index))) {
+        return;
+    }
+
+    b->words[w] &= ~BIT(index);
+    b->n_set -= 1;
+    b->full[WORD(w)] &= ~BIT(w);
+    if (WORD(w) < b->hint) {
+        b->hint = WORD(w);
+    }
+}
+
+// Sets up to n of the lowest cleared bits and writes their indices in
+// ascending order to out
+// Returns the number of bits set
+size_t bitmap_take_zeros(bitmap_t *b, size_t n, long *out) {
+    size_t taken = 0;
+
+    while (taken < n) {
+        size_t w = first_free_word(b);
+        STAT_INC(frame_scan_steps);
+        if (w >= b->n_words) {
+            // No cleared bits left
+            break;
+        }
+
+        // Claim as many of the word's lowest cleared bits as are needed in
+        // one go
+        uint64_t zeros = ~b->words[w];
+        uint64_t claimed = 0;
+        while (zeros && taken < n) {
+            uint64_t lowest = zeros & -zeros;
+            zeros ^= lowest;
+            claimed |= lowest;
+            out[taken++] = w * BITMAP_WORD_BITS + __builtin_ctzll(lowest);
+        }
+
+        b->words[w] |= claimed;
+        if (b->words[w] == FULL_WORD) {
+            b->full[WORD(w)] |= BIT(w);
+        }
+    }
+
+    b->n_set += taken;
+    return taken;
+}
+
+// Frees the bitmap
+void bitmap_free(bitmap_t *b) {
+    free(b->words);
+    free(b->full);
+    free(b);
+}
+
+// Finds the lowest word that still has a cleared bit
+// Returns n_words if every word is full
+size_t first_free_word(bitmap_t *b) {
+    // Summary words before the hint are full, so scans resume where the last
+    // one stopped instead of passing over the full low frames every time
+    for (size_t i = b->hint; i < b->n_full_words; i++) {
+        STAT_INC(frame_scan_steps);
+        if (b->full[i] != FULL_WORD) {
+            b->hint = i;
+            return i * BITMAP_WORD_BITS + __builtin_ctzll(~b->full[i]);
+        }
+    }
+
+    b->hint = b->n_full_words;
+    return b->n_words;
+}
@@ -0,0 +1,43 @@
+#ifndef _BITMAP_H_
+#define _BITMAP_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Number of bits held in each word of a bitmap
+#define BITMAP_WORD_BITS 64
+
+// Struct for a packed bitmap with a summary level of full words
+// Bits are found lowest index first, so they are handed out in the same order
+// as a linear scan from bit 0 would
+typedef struct bitmap {
+    uint64_t *words; // The bits, BITMAP_WORD_BITS per word
+    uint64_t *full;  // Summary level, one bit set per word with no zero bits
+    size_t n_bits;
+    size_t n_words;
+    size_t n_full_words;
+    size_t n_set; // Number of bits currently set
+    size_t hint;  // No summary word before this one has a cleared bit
+} bitmap_t;
+
+// Creates and returns a new bitmap of n_bits cleared bits
+bitmap_t *new_bitmap(size_t n_bits);
+
+// Returns 1 if the bit at index is set, 0 otherwise
+int bitmap_test(bitmap_t *b, size_t index);
+
+// Sets the bit at the provided index
+void bitmap_set(bitmap_t *b, size_t index);
+
+// Clears the bit at the provided index
+void bitmap_clear(bitmap_t *b, size_t index);
+
+// Sets up to n of the lowest cleared bits and writes their indices in
+// ascending order to out
+// Returns the number of bits set
+size_t bitmap_take_zeros(bitmap_t *b, size_t n, long *out);
+
+// Frees the bitmap
+void bitmap_free(bitmap_t *b);
+
+#endif
@@ -0,0 +1,238 @@
+#include "blocktree.h"
+#include "stats.h"
+#include <assert.h>
+#include <stdlib.h>
+
+#define MAX(a, b) (a > b ? a : b)
+
+// Returns the height of a subtree, 0 if empty
+int tree_height(tree_node_t *node);
+
+// Returns the largest block size in a subtree, 0 if empty
+size_t tree_max(tree_node_t *node);
+
+// Recalculates a node's height and max from its children
+void tree_update(tree_node_t *node);
+
+// Restores the AVL balance of a subtree after an insertion or removal
+// Returns the new root of the subtree
+tree_node_t *tree_balance(tree_node_t *node);
+
+// Inserts a node into a subtree
+// Returns the new root of the subtree
+tree_node_t *tree_insert(tree_node_t *root, tree_node_t *node);
+
+// Removes the node with the given start address from a subtree
+// Returns the new root of the subtree
+tree_node_t *tree_remove(block_tree_t *tree, tree_node_t *root, size_t start);
+
+// Detaches the lowest addressed node of a subtree into min
+// Returns the new root of the subtree
+tree_node_t *tree_remove_min(tree_node_t *root, tree_node_t **min);
+
+// Creates and returns a new empty block tree
+block_tree_t *new_block_tree() {
+    block_tree_t *tree = malloc(sizeof(*tree));
+    assert(tree);
+
+    tree->root = NULL;
+    tree->len = 0;
+    tree->pool = new_pool(sizeof(tree_node_t));
+
+    return tree;
+}
+
+// Adds a block starting at start of the given size, holding data
+void block_tree_insert(block_tree_t *tree, size_t start, size_t size,
+                       void *data) {
+    tree_node_t *node = pool_alloc(tree->pool);
+
+    node->start = start;
+    node->size = size;
+    node->max = size;
+    node->height = 1;
+    node->data = data;
+    node->left = NULL;
+    node->right = NULL;
+
+    tree->root = tree_insert(tree->root, node);
+    tree->len += 1;
+}
+
+// Removes the block starting at start from the tree, if it exists
+void block_tree_remove(block_tree_t *tree, size_t start) {
+    tree->root = tree_remove(tree, tree->root, start);
+}
+
+// Finds the lowest addressed block with at least the given size
+// Returns a pointer to the block's data, NULL if no block is big enough
+void *block_tree_first_fit(block_tree_t *tree, size_t size) {
+    tree_node_t *curr = tree->root;
+
+    if (tree_max(curr) < size) {
+        // No block is big enough
+        return NULL;
+    }
+
+    // Descend towards the lowest addresses, only entering subtrees known to
+    // hold a big enough block
+    while (curr) {
+        STAT_INC(blocks_scanned);
+        if (tree_max(curr->left) >= size) {
+            curr = curr->left;
+        } else if (curr->size >= size) {
+            return curr->data;
+        } else {
+            curr = curr->right;
+        }
+    }
+
+    return NULL;
+}
+
+// Finds the block starting at start
+// Returns a pointer to the block's data, NULL if there is no such block
+void *block_tree_find(block_tree_t *tree, size_t start) {
+    tree_node_t *curr = tree->root;
+
+    while (curr && curr->start != start) {
+        curr = start < curr->start ? curr->left : curr->right;
+    }
+
+    return curr ? curr->data : NULL;
+}
+
+// Returns the size of the largest block in the tree, 0 if it is empty
+size_t block_tree_max(block_tree_t *tree) {
+    return tree_max(tree->root);
+}
+
+// Frees the tree, leaving the data it holds untouched
+void block_tree_free(block_tree_t *tree) {
+    pool_free(tree->pool);
+    free(tree);
+}
+
+// Returns the height of a subtree, 0 if empty
+int tree_height(tree_node_t *node) {
+    return node ? node->height : 0;
+}
+
+// Returns the largest block size in a subtree, 0 if empty
+size_t tree_max(tree_node_t *node) {
+    return node ? node->max : 0;
+}
+
+// Recalculates a node's height and max from its children
+void tree_update(tree_node_t *node) {
+    node->height = 1 + MAX(tree_height(node->left), tree_height(node->right));
+    node->max = MAX(tree_max(node->left), tree_max(node->right));
+    node->max = MAX(node->max, node->size);
+}
+
+// Restores the AVL balance of a subtree after an insertion or removal
+// Returns the new root of the subtree
+tree_node_t *tree_balance(tree_node_t *node) {
+    tree_update(node);
+
+    int balance = tree_height(node->left) - tree_height(node->right);
+
+    if (balance > 1) {
+        // Left heavy, rotate right, first rotating the left child if it leans
+        // right
+        tree_node_t *left = node->left;
+        if (tree_height(left->left) < tree_height(left->right)) {
+            tree_node_t *pivot = left->right;
+            left->right = pivot->left;
+            pivot->left = left;
+            tree_update(left);
+            left = pivot;
+        }
+        node->left = left->right;
+        left->right = node;
+        tree_update(node);
+        tree_update(left);
+        return left;
+    }
+
+    if (balance < -1) {
+        // Right heavy, rotate left, first rotating the right child if it
+        // leans left
+        tree_node_t *right = node->right;
+        if (tree_height(right->right) < tree_height(right->left)) {
+            tree_node_t *pivot = right->left;
+            right->left = pivot->right;
+            pivot->right = right;
+            tree_update(right);
+            right = pivot;
+        }
+        node->right = right->left;
+        right->left = node;
+        tree_update(node);
+        tree_update(right);
+        return right;
+    }
+
+    return node;
+}
+
+// Inserts a node into a subtree
+// Returns the new root of the subtree
+tree_node_t *tree_insert(tree_node_t *root, tree_node_t *node) {
+    if (!root) {
+        return node;
+    }
+
+    if (node->start < root->start) {
+        root->left = tree_insert(root->left, node);
+    } else {
+        root->right = tree_insert(root->right, node);
+    }
+
+    return tree_balance(root);
+}
+
+// Removes the node with the given start address from a subtree
+// Returns the new root of the subtree
+tree_node_t *tree_remove(block_tree_t *tree, tree_node_t *root, size_t start) {
+    if (!root) {
+        // Not in the tree
+        return NULL;
+    }
+
+    if (start < root->start) {
+        root->left = tree_remove(tree, root->left, start);
+    } else if (start > root->start) {
+        root->right = tree_remove(tree, root->right, start);
+    } else {
+        // Found the node, replace it with its successor
+        tree_node_t *left = root->left;
+        tree_node_t *right = root->right;
+        pool_release(tree->pool, root);
+        tree->len -= 1;
+
+        if (!right) {
+            return left;
+        }
+
+        tree_node_t *successor;
+        right = tree_remove_min(right, &successor);
+        successor->left = left;
+        successor->right = right;
+        root = successor;
+    }
+
+    return tree_balance(root);
+}
+
+// Detaches the lowest addressed node of a subtree into min
+// Returns the new root of the subtree
+tree_node_t *tree_remove_min(tree_node_t *root, tree_node_t **min) {
+    if (!root->left) {
+        *min = root;
+        return root->right;
+    }
+
+    root->left = tree_remove_min(root->left, min);
+    return tree_balance(root);
+}
@@ -0,0 +1,52 @@
+#ifndef _BLOCK_TREE_H_
+#define _BLOCK_TREE_H_
+
+#include "pool.h"
+#include <stdlib.h>
+
+typedef struct tree_node tree_node_t;
+
+// Struct for a node in an address ordered AVL tree of memory blocks
+// Each node also tracks the largest block size in its subtree
+struct tree_node {
+    size_t start; // Start address of the block, the tree's key
+    size_t size;  // Size of the block
+    size_t max;   // Largest block size in the subtree rooted at this node
+    int height;
+    void *data;
+    tree_node_t *left;
+    tree_node_t *right;
+};
+
+// Struct for an address ordered tree of memory blocks
+typedef struct block_tree {
+    tree_node_t *root;
+    size_t len;
+    pool_t *pool; // Pool the tree's nodes are allocated from
+} block_tree_t;
+
+// Creates and returns a new empty block tree
+block_tree_t *new_block_tree();
+
+// Adds a block starting at start of the given size, holding data
+void block_tree_insert(block_tree_t *tree, size_t start, size_t size,
+                       void *data);
+
+// Removes the block starting at start from the tree, if it exists
+void block_tree_remove(block_tree_t *tree, size_t start);
+
+// Finds the lowest addressed block with at least the given size
+// Returns a pointer to the block's data, NULL if no block is big enough
+void *block_tree_first_fit(block_tree_t *tree, size_t size);
+
+// Finds the block starting at start
+// Returns a pointer to the block's data, NULL if there is no such block
+void *block_tree_find(block_tree_t *tree, size_t start);
+
+// Returns the size of the largest block in the tree, 0 if it is empty
+size_t block_tree_max(block_tree_t *tree);
+
+// Frees the tree, leaving the data it holds untouched
+void block_tree_free(block_tree_t *tree);
+
+#endif
@@ -0,0 +1,946 @@
+#include "checkpoint.h"
+#include "bitmap.h"
+#include "stats.h"
+#include "trace.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Suffix of the file a checkpoint is written to before it replaces the last
+#define CHECKPOINT_TMP_SUFFIX ".tmp"
+
+// Number of counters in a stats_t, which holds nothing but size_t counters
+#define N_COUNTERS (sizeof(stats_t) / sizeof(size_t))
+
+// Bound of the process fields and ids kept in 32 bits
+#define UINT32_LIMIT ((uint64_t)UINT32_MAX + 1)
+
+// Struct for reading a checkpoint held in memory
+typedef struct checkpoint_reader {
+    const uint8_t *cursor; // NULL once the checkpoint is found to be corrupt
+    const uint8_t *end;
+    process_t **by_id; // Restored processes by id, NULL for finished ones
+    size_t n_arrived;
+} ckpt_reader_t;
+
+// Writes a varint to a checkpoint
+void write_uint(out_t *out, uint64_t value);
+
+// Writes a long double to a checkpoint in its native representation
+void write_long_double(out_t *out, long double value);
+
+// Writes a process's details to a checkpoint, without its id
+void write_process(out_t *out, process_t *p);
+
+// Writes the blocks of contiguous memory and the processes they belong to
+void write_cont_mem(out_t *out, cont_mem_t *mem, process_t **live,
+                    size_t n_live);
+
+// Writes the blocks of buddy memory and the processes they belong to
+void write_buddy_mem(out_t *out, buddy_mem_t *mem, process_t **live,
+                     size_t n_live);
+
+// Writes the free blocks in a subtree of the tree of an order's free blocks
+void write_free_blocks(out_t *out, tree_node_t *node, size_t order);
+
+// Writes the page tables of the processes and the state of the frames
+void write_paged_mem(out_t *out, paged_mem_t *mem, process_t **live,
+                     size_t n_live);
+
+// Reads the scheduler's state from a checkpoint into a new scheduler
+// Returns 1 if successful, 0 if the checkpoint is corrupt
+int read_rr(ckpt_reader_t *in, rr_t *rr, policy_opt_t policy);
+
+// Reads a varint from a checkpoint
+// Returns 0 if the checkpoint is corrupt
+uint64_t read_uint(ckpt_reader_t *in);
+
+// Reads a varint that must be below limit, marking the checkpoint corrupt if
+// it isn't
+uint64_t read_below(ckpt_reader_t *in, uint64_t limit);
+
+// Reads a long double stored in its native representation
+long double read_long_double(ckpt_reader_t *in);
+
+// Reads a process's details, allocating it from pool
+process_t *read_process(ckpt_reader_t *in, pool_t *pool);
+
+// Reads an id and returns the restored process with it
+// Returns NULL, marking the checkpoint corrupt, if there is no such process
+process_t *read_id(ckpt_reader_t *in);
+
+// Returns the restored process with the given id, marking it as placed on a
+// core
+// Returns NULL, marking the checkpoint corrupt, if there is no such process
+// or it was already placed
+process_t *place_process(ckpt_reader_t *in, bitmap_t *placed, size_t id);
+
+// Reads the blocks of contiguous memory, giving processes theirs
+void read_cont_mem(ckpt_reader_t *in, cont_mem_t *mem);
+
+// Returns the index of the block starting at start in an address ordered
+// array of n block list nodes, n if there is none
+size_t find_block(node_t **nodes, size_t n, size_t start);
+
+// Reads the blocks of buddy memory, giving processes theirs
+void read_buddy_mem(ckpt_reader_t *in, buddy_mem_t *mem);
+
+// Reads a buddy block's start and order, allocating a free block for it
+// Returns NULL, marking the checkpoint corrupt, if it isn't a valid block
+mem_block_t *read_buddy_block(ckpt_reader_t *in, buddy_mem_t *mem);
+
+// Reads the page tables of processes and the state of the frames
+void read_paged_mem(ckpt_reader_t *in, paged_mem_t *mem);
+
+// Frees the page tables given to restored processes, which the scheduler
+// doesn't free as it only frees memory of processes that finish
+void free_page_tables(ckpt_reader_t *in, rr_t *rr);
+
+// Writes a checkpoint of the scheduler's state between two cycles to a file,
+// replacing any previous checkpoint in it. The output written so far is
+// flushed first, so it matches the checkpoint
+// Returns 1 if successful, 0 if the file can't be written
+int checkpoint_save(rr_t *rr, char *filename) {
+    out_flush(rr->out);
+    if (rr->trace) {
+        out_flush(rr->trace->out);
+    }
+
+    // Written beside the last checkpoint and then moved over it, so a crash
+    // while writing leaves the last checkpoint intact
+    char *tmp = malloc(strlen(filename) + sizeof(CHECKPOINT_TMP_SUFFIX));
+    assert(tmp);
+    strcpy(tmp, filename);
+    strcat(tmp, CHECKPOINT_TMP_SUFFIX);
+
+    FILE *file = fopen(tmp, "wb");
+    if (!file) {
+        free(tmp);
+        return 0;
+    }
+    out_t *out = new_output(file);
+
+    out_bytes(out, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LENGTH);
+    out_char(out, sizeof(long double));
+
+    run_opts_t *opts = rr->opts;
+    write_uint(out, opts->mem);
+    write_uint(out, opts->cores);
+    write_uint(out, opts->mem_size);
+    write_uint(out, opts->frame_size);
+    write_uint(out, opts->min_pages);
+    write_uint(out, opts->replace);
+    write_uint(out, opts->policy);
+
+    write_uint(out, rr->time);
+    write_uint(out, rr->n_arrived);
+    write_uint(out, rr->n_read);
+    write_uint(out, rr->next_balance);
+    write_uint(out, rr->process_count);
+    write_long_double(out, rr->avg_turnaround);
+    write_long_double(out, rr->total_overhead);
+    write_long_double(out, rr->max_overhead);
+
+    write_uint(out, N_COUNTERS);
+    for (size_t i = 0; i < N_COUNTERS; i++) {
+        write_uint(out, ((size_t *)&stats)[i]);
+    }
+
+    // Every process that has arrived and not finished is running or ready on
+    // a core, gather them in the order cores hold them
+    process_t **live =
+        malloc(sizeof(*live) * (rr->n_ready + rr->n_cores + 1));
+    assert(live);
+    size_t n_live = 0;
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        if (core->running) {
+            live[n_live++] = core->running;
+        }
+        policy_ready(core->policy, &live[n_live]);
+        n_live += core->policy->len;
+    }
+
+    write_uint(out, n_live);
+    for (size_t i = 0; i < n_live; i++) {
+        write_uint(out, live[i]->id);
+        write_process(out, live[i]);
+    }
+
+    size_t next = 0;
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        write_uint(out, core->busy);
+        write_uint(out, core->migrations);
+        write_uint(out, core->running ? core->running->id + 1 : 0);
+        if (core->running) {
+            next++;
+        }
+        if (opts->policy == CFS) {
+            write_uint(out, ((cfs_policy_t *)core->policy->data)->min_vruntime);
+        }
+
+        write_uint(out, core->policy->len);
+        for (size_t j = 0; j < core->policy->len; j++) {
+            write_uint(out, live[next++]->id);
+        }
+        write_uint(out, core->blocked ? core->blocked_largest + 1 : 0);
+        if (core->blocked) {
+            write_uint(out, core->blocked_smallest);
+        }
+    }
+
+    write_uint(out, rr->lru->len);
+    for (node_t *node = rr->lru->head; node; node = node->next) {
+        write_uint(out, ((process_t *)node->data)->id);
+    }
+
+    write_uint(out, rr->processes->len);
+    for (size_t i = 0; i < rr->processes->len; i++) {
+        write_process(out, queue_get(rr->processes, i));
+    }
+
+    switch (opts->mem) {
+    case INFINITE:
+        break;
+    case FIRST_FIT:
+    case SEG_FIT:
+        write_cont_mem(out, rr->mem->data, live, n_live);
+        break;
+    case BUDDY:
+        write_buddy_mem(out, rr->mem->data, live, n_live);
+        break;
+    case PAGED:
+    case VIRTUAL:
+        write_paged_mem(out, rr->mem->data, live, n_live);
+        break;
+    }
+    free(live);
+
+    out_free(out);
+    int ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(tmp, filename) == 0;
+    free(tmp);
+
+    return ok;
+}
+
+// Creates a scheduler configured by the run options, in the state saved in a
+// checkpoint file
+// Returns NULL if the file can't be read, is corrupt or was saved with other
+// memory options or number of cores
+rr_t *checkpoint_restore(run_opts_t *opts, char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size < CHECKPOINT_MAGIC_LENGTH + 1) {
+        fclose(file);
+        return NULL;
+    }
+
+    uint8_t *data = malloc(size);
+    assert(data);
+    size_t len = fread(data, 1, size, file);
+    fclose(file);
+
+    // Long doubles are only readable by builds that store them the same way
+    if (len < CHECKPOINT_MAGIC_LENGTH + 1 ||
+        memcmp(data, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LENGTH) != 0 ||
+        data[CHECKPOINT_MAGIC_LENGTH] != sizeof(long double)) {
+        free(data);
+        return NULL;
+    }
+    ckpt_reader_t in = {data + CHECKPOINT_MAGIC_LENGTH + 1, data + len, NULL,
+                        0};
+
+    // The options shaping memory and cores must match, every option read is
+    // compared so all of them are read
+    int matches = read_uint(&in) == opts->mem;
+    matches &= read_uint(&in) == opts->cores;
+    matches &= read_uint(&in) == opts->mem_size;
+    matches &= read_uint(&in) == opts->frame_size;
+    matches &= read_uint(&in) == opts->min_pages;
+    matches &= read_uint(&in) == opts->replace;
+    policy_opt_t policy = read_below(&in, CFS + 1);
+    if (!in.cursor || !matches) {
+        free(data);
+        return NULL;
+    }
+
+    rr_t *rr = new_rr(opts);
+    int ok = read_rr(&in, rr, policy) && in.cursor == in.end;
+    if (!ok) {
+        free_page_tables(&in, rr);
+    }
+    free(in.by_id);
+    free(data);
+
+    if (!ok) {
+        rr_free(rr);
+        return NULL;
+    }
+    return rr;
+}
+
+// Reads the scheduler's state from a checkpoint into a new scheduler
+// Returns 1 if successful, 0 if the checkpoint is corrupt
+int read_rr(ckpt_reader_t *in, rr_t *rr, policy_opt_t policy) {
+    rr->time = read_uint(in);
+    rr->n_arrived = read_below(in, UINT32_LIMIT);
+    rr->n_read = read_uint(in);
+    rr->next_balance = read_uint(in);
+    rr->process_count = read_uint(in);
+    rr->avg_turnaround = read_long_double(in);
+    rr->total_overhead = read_long_double(in);
+    rr->max_overhead = read_long_double(in);
+    rr->next_checkpoint = (rr->time / rr->opts->checkpoint_every + 1) *
+                          rr->opts->checkpoint_every;
+
+    // Counters are only restored at the end, so restoring isn't counted
+    stats_t counters;
+    if (read_uint(in) != N_COUNTERS) {
+        in->cursor = NULL;
+    }
+    for (size_t i = 0; i < N_COUNTERS; i++) {
+        ((size_t *)&counters)[i] = read_uint(in);
+    }
+    if (!in->cursor) {
+        return 0;
+    }
+
+    in->n_arrived = rr->n_arrived;
+    in->by_id = calloc(rr->n_arrived + 1, sizeof(*in->by_id));
+    assert(in->by_id);
+
+    size_t n_live = read_below(in, rr->n_arrived + 1);
+    for (size_t i = 0; i < n_live && in->cursor; i++) {
+        size_t id = read_below(in, rr->n_arrived);
+        process_t *p = read_process(in, rr->process_pool);
+        if (!in->cursor || in->by_id[id]) {
+            in->cursor = NULL;
+            break;
+        }
+        p->id = id;
+        in->by_id[id] = p;
+    }
+
+    // Every restored process is running or ready on exactly one core
+    bitmap_t *placed = new_bitmap(rr->n_arrived);
+    for (size_t i = 0; i < rr->n_cores && in->cursor; i++) {
+        core_t *core = &rr->cores[i];
+        core->busy = read_uint(in);
+        core->migrations = read_uint(in);
+
+        size_t running = read_below(in, rr->n_arrived + 1);
+        if (running) {
+            core->running = place_process(in, placed, running - 1);
+            if (core->running) {
+                core->running->running = 1;
+            }
+        }
+
+        // A what-if run with another policy starts it afresh
+        if (policy == CFS) {
+            size_t min_vruntime = read_uint(in);
+            if (rr->opts->policy == CFS) {
+                ((cfs_policy_t *)core->policy->data)->min_vruntime =
+                    min_vruntime;
+            }
+        }
+
+        size_t n_ready = read_below(in, n_live + 1);
+        for (size_t j = 0; j < n_ready && in->cursor; j++) {
+            process_t *p = place_process(in, placed, read_uint(in));
+            if (p) {
+                policy_enqueue(core->policy, p);
+                rr->n_ready += 1;
+            }
+        }
+
+        // Which processes fit was found in the order of the saved policy
+        size_t blocked = read_uint(in);
+        size_t smallest = blocked ? read_uint(in) : 0;
+        if (blocked && policy == rr->opts->policy) {
+            core->blocked = 1;
+            core->blocked_largest = blocked - 1;
+            core->blocked_smallest = smallest;
+        }
+    }
+    if (placed->n_set != n_live) {
+        in->cursor = NULL;
+    }
+    bitmap_free(placed);
+
+    size_t n_lru = read_below(in, n_live + 1);
+    for (size_t i = 0; i < n_lru && in->cursor; i++) {
+        process_t *p = read_id(in);
+        if (p && p->lru) {
+            in->cursor = NULL;
+        } else if (p) {
+            p->lru = list_add_tail(rr->lru, p);
+        }
+    }
+
+    size_t n_pending = read_uint(in);
+    for (size_t i = 0; i < n_pending && in->cursor; i++) {
+        enqueue(rr->processes, read_process(in, rr->process_pool));
+    }
+
+    switch (rr->opts->mem) {
+    case INFINITE:
+        break;
+    case FIRST_FIT:
+    case SEG_FIT:
+        read_cont_mem(in, rr->mem->data);
+        break;
+    case BUDDY:
+        read_buddy_mem(in, rr->mem->data);
+        break;
+    case PAGED:
+    case VIRTUAL:
+        read_paged_mem(in, rr->mem->data);
+        break;
+    }
+
+    if (!in->cursor) {
+        return 0;
+    }
+    stats = counters;
+
+    // A restored trace starts afresh, so it names the processes it will
+    // refer to that arrived before the checkpoint
+    for (size_t id = 0; rr->trace && id < rr->n_arrived; id++) {
+        if (in->by_id[id]) {
+            trace_arrival(rr->trace, id, in->by_id[id]->name);
+        }
+    }
+
+    return 1;
+}
+
+// Writes a varint to a checkpoint
+void write_uint(out_t *out, uint64_t value) {
+    uint8_t buf[TRACE_MAX_VARINT];
+    out_bytes(out, buf, varint_encode(buf, value));
+}
+
+// Writes a long double to a checkpoint in its native representation
+void write_long_double(out_t *out, long double value) {
+    out_bytes(out, &value, sizeof(value));
+}
+
+// Writes a process's details to a checkpoint, without its id
+void write_process(out_t *out, process_t *p) {
+    size_t len = strlen(p->name);
+
+    write_uint(out, len);
+    out_bytes(out, p->name, len);
+    write_uint(out, p->arrived);
+    write_uint(out, p->service);
+    write_uint(out, p->remaining);
+    write_uint(out, p->mem_size);
+    write_uint(out, p->vruntime);
+}
+
+// Reads a varint from a checkpoint
+// Returns 0 if the checkpoint is corrupt
+uint64_t read_uint(ckpt_reader_t *in) {
+    if (!in->cursor) {
+        return 0;
+    }
+
+    return varint_decode(&in->cursor, in->end);
+}
+
+// Reads a varint that must be below limit, marking the checkpoint corrupt if
+// it isn't
+uint64_t read_below(ckpt_reader_t *in, uint64_t limit) {
+    uint64_t value = read_uint(in);
+    if (value >= limit) {
+        in->cursor = NULL;
+        return 0;
+    }
+
+    return value;
+}
+
+// Reads a long double stored in its native representation
+long double read_long_double(ckpt_reader_t *in) {
+    long double value = 0;
+    if (!in->cursor || (size_t)(in->end - in->cursor) < sizeof(value)) {
+        in->cursor = NULL;
+        return value;
+    }
+
+    memcpy(&value, in->cursor, sizeof(value));
+    in->cursor += sizeof(value);
+    return value;
+}
+
+// Reads a process's details, allocating it from pool
+process_t *read_process(ckpt_reader_t *in, pool_t *pool) {
+    process_t *p = pool_alloc(pool);
+
+    size_t len = read_below(in, NAME_MAX_LENGTH + 1);
+    if (in->cursor && (size_t)(in->end - in->cursor) >= len) {
+        memcpy(p->name, in->cursor, len);
+        in->cursor += len;
+    } else {
+        in->cursor = NULL;
+        len = 0;
+    }
+    p->name[len] = '\0';
+
+    p->arrived = read_below(in, UINT32_LIMIT);
+    p->service = read_below(in, UINT32_LIMIT);
+    p->remaining = read_below(in, UINT32_LIMIT);
+    p->mem_size = read_below(in, UINT32_LIMIT);
+    p->vruntime = read_uint(in);
+    p->mem = NULL;
+    p->lru = NULL;
+    p->id = 0;
+    p->running = 0;
+
+    return p;
+}
+
+// Reads an id and returns the restored process with it
+// Returns NULL, marking the checkpoint corrupt, if there is no such process
+process_t *read_id(ckpt_reader_t *in) {
+    size_t id = read_below(in, in->n_arrived);
+    if (!in->cursor || !in->by_id[id]) {
+        in->cursor = NULL;
+        return NULL;
+    }
+
+    return in->by_id[id];
+}
+
+// Returns the restored process with the given id, marking it as placed on a
+// core
+// Returns NULL, marking the checkpoint corrupt, if there is no such process
+// or it was already placed
+process_t *place_process(ckpt_reader_t *in, bitmap_t *placed, size_t id) {
+    if (!in->cursor || id >= in->n_arrived || !in->by_id[id] ||
+        bitmap_test(placed, id)) {
+        in->cursor = NULL;
+        return NULL;
+    }
+
+    bitmap_set(placed, id);
+    return in->by_id[id];
+}
+
+// Contiguous memory checkpoint implementations
+// --------------------------------
+// -------------------------------------------------------------------------------
+
+// Writes the blocks of contiguous memory and the processes they belong to
+void write_cont_mem(out_t *out, cont_mem_t *mem, process_t **live,
+                    size_t n_live) {
+    write_uint(out, mem->blocks->len);
+    for (node_t *node = mem->blocks->head; node; node = node->next) {
+        write_uint(out, ((mem_block_t *)node->data)->size);
+        write_uint(out, ((mem_block_t *)node->data)->allocated);
+    }
+
+    size_t n_owners = 0;
+    for (size_t i = 0; i < n_live; i++) {
+        n_owners += live[i]->mem != NULL;
+    }
+    write_uint(out, n_owners);
+    for (size_t i = 0; i < n_live; i++) {
+        if (live[i]->mem) {
+            write_uint(out, live[i]->id);
+            write_uint(out,
+                       ((mem_block_t *)((node_t *)live[i]->mem)->data)->start);
+        }
+    }
+
+    // Segregated fit takes the first big enough block of a class, so the
+    // order of each class's list matters
+    for (size_t class = 0; mem->classes && class < SIZE_CLASSES; class++) {
+        write_uint(out, mem->classes[class]->len);
+        for (node_t *node = mem->classes[class]->head; node;
+             node = node->next) {
+            write_uint(out,
+                       ((mem_block_t *)((node_t *)node->data)->data)->start);
+        }
+    }
+
+    write_uint(out, mem->compactions);
+    write_uint(out, mem->compacted);
+}
+
+// Reads the blocks of contiguous memory, giving processes theirs
+void read_cont_mem(ckpt_reader_t *in, cont_mem_t *mem) {
+    // Start over without the single free block memory starts as
+    node_t *initial = mem->blocks->head;
+    free_index_remove(mem, initial);
+    pool_release(mem->block_pool, list_remove(mem->blocks, initial));
+
+    size_t n_blocks = read_below(in, mem->total + 1);
+    node_t **nodes = malloc(sizeof(*nodes) * (n_blocks + 1));
+    assert(nodes);
+
+    size_t n = 0, start = 0, n_allocated = 0;
+    while (n < n_blocks && in->cursor) {
+        size_t size = read_below(in, mem->total - start + 1);
+        int allocated = read_below(in, 2);
+        if (!in->cursor || size == 0) {
+            in->cursor = NULL;
+            break;
+        }
+
+        mem_block_t *block = pool_alloc(mem->block_pool);
+        block->allocated = allocated;
+        block->start = start;
+        block->end = start + size - 1;
+        block->size = size;
+        block->class_node = NULL;
+        nodes[n] = list_add_tail(mem->blocks, block);
+
+        if (allocated) {
+            mem->used += size;
+            n_allocated++;
+        } else if (!mem->classes) {
+            free_index_add(mem, nodes[n]);
+        }
+        start += size;
+        n++;
+    }
+    if (start != mem->total) {
+        in->cursor = NULL;
+    }
+
+    // Every allocated block belongs to exactly one process
+    bitmap_t *owned = new_bitmap(n);
+    size_t n_owners = read_below(in, n + 1);
+    for (size_t i = 0; i < n_owners && in->cursor; i++) {
+        process_t *p = read_id(in);
+        size_t b = find_block(nodes, n, read_uint(in));
+        if (!p || p->mem || b >= n ||
+            !((mem_block_t *)nodes[b]->data)->allocated ||
+            bitmap_test(owned, b)) {
+            in->cursor = NULL;
+            break;
+        }
+
+        bitmap_set(owned, b);
+        p->mem = nodes[b];
+    }
+    if (owned->n_set != n_allocated) {
+        in->cursor = NULL;
+    }
+    bitmap_free(owned);
+
+    // And every free block is in exactly one size class
+    size_t n_indexed = 0;
+    for (size_t class = 0; mem->classes && class < SIZE_CLASSES; class++) {
+        size_t len = read_below(in, n + 1);
+        for (size_t i = 0; i < len && in->cursor; i++) {
+            size_t b = find_block(nodes, n, read_uint(in));
+            mem_block_t *block = b < n ? nodes[b]->data : NULL;
+            if (!block || block->allocated || block->class_node ||
+                size_class(block->size) != class) {
+                in->cursor = NULL;
+                break;
+            }
+
+            free_index_add(mem, nodes[b]);
+            n_indexed++;
+        }
+    }
+    if (mem->classes && n_indexed != n - n_allocated) {
+        in->cursor = NULL;
+    }
+
+    mem->compactions = read_uint(in);
+    mem->compacted = read_uint(in);
+
+    free(nodes);
+}
+
+// Returns the index of the block starting at start in an address ordered
+// array of n block list nodes, n if there is none
+size_t find_block(node_t **nodes, size_t n, size_t start) {
+    size_t low = 0, high = n;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        size_t mid_start = ((mem_block_t *)nodes[mid]->data)->start;
+        if (mid_start == start) {
+            return mid;
+        } else if (mid_start < start) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return n;
+}
+
+// Buddy memory checkpoint implementations
+// ------------------------------------
+// -------------------------------------------------------------------------------
+
+// Writes the blocks of buddy memory and the processes they belong to
+void write_buddy_mem(out_t *out, buddy_mem_t *mem, process_t **live,
+                     size_t n_live) {
+    size_t n_free = 0;
+    for (size_t order = 0; order <= mem->max_order; order++) {
+        n_free += mem->free[order]->len;
+    }
+    write_uint(out, n_free);
+    for (size_t order = 0; order <= mem->max_order; order++) {
+        write_free_blocks(out, mem->free[order]->root, order);
+    }
+
+    size_t n_owners = 0;
+    for (size_t i = 0; i < n_live; i++) {
+        n_owners += live[i]->mem != NULL;
+    }
+    write_uint(out, n_owners);
+    for (size_t i = 0; i < n_live; i++) {
+        mem_block_t *block = (mem_block_t *)live[i]->mem;
+        if (block) {
+            write_uint(out, live[i]->id);
+            write_uint(out, block->start);
+            write_uint(out, buddy_order(block->size));
+        }
+    }
+}
+
+// Writes the free blocks in a subtree of the tree of an order's free blocks
+void write_free_blocks(out_t *out, tree_node_t *node, size_t order) {
+    if (!node) {
+        return;
+    }
+
+    write_free_blocks(out, node->left, order);
+    write_uint(out, node->start);
+    write_uint(out, order);
+    write_free_blocks(out, node->right, order);
+}
+
+// Reads the blocks of buddy memory, giving processes theirs
+void read_buddy_mem(ckpt_reader_t *in, buddy_mem_t *mem) {
+    // Start over without the free blocks memory starts as
+    for (size_t order = 0; order <= mem->max_order; order++) {
+        mem_block_t *block;
+        while ((block = block_tree_first_fit(mem->free[order], 1))) {
+            block_tree_remove(mem->free[order], block->start);
+            pool_release(mem->block_pool, block);
+        }
+    }
+
+    // Blocks must cover all of memory
+    size_t covered = 0;
+
+    size_t n_free = read_uint(in);
+    for (size_t i = 0; i < n_free && in->cursor; i++) {
+        mem_block_t *block = read_buddy_block(in, mem);
+        if (!block) {
+            break;
+        }
+
+        size_t order = buddy_order(block->size);
+        if (block_tree_find(mem->free[order], block->start)) {
+            in->cursor = NULL;
+            pool_release(mem->block_pool, block);
+            break;
+        }
+        block_tree_insert(mem->free[order], block->start, block->size, block);
+        covered += block->size;
+    }
+
+    size_t n_owners = read_uint(in);
+    for (size_t i = 0; i < n_owners && in->cursor; i++) {
+        process_t *p = read_id(in);
+        mem_block_t *block = read_buddy_block(in, mem);
+        if (!p || p->mem || !block) {
+            in->cursor = NULL;
+            break;
+        }
+
+        block->allocated = 1;
+        p->mem = block;
+        mem->used += block->size;
+        mem->requested += p->mem_size;
+        covered += block->size;
+    }
+
+    if (covered != mem->total) {
+        in->cursor = NULL;
+    }
+}
+
+// Reads a buddy block's start and order, allocating a free block for it
+// Returns NULL, marking the checkpoint corrupt, if it isn't a valid block
+mem_block_t *read_buddy_block(ckpt_reader_t *in, buddy_mem_t *mem) {
+    size_t start = read_uint(in);
+    size_t size = (size_t)1 << read_below(in, mem->max_order + 1);
+
+    // Every block starts at a multiple of its size
+    if (!in->cursor || start % size || start + size > mem->total) {
+        in->cursor = NULL;
+        return NULL;
+    }
+
+    mem_block_t *block = pool_alloc(mem->block_pool);
+    block->allocated = 0;
+    block->start = start;
+    block->size = size;
+    block->end = start + size - 1;
+    block->class_node = NULL;
+
+    return block;
+}
+
+// Paged memory checkpoint implementations
+// ------------------------------------
+// -------------------------------------------------------------------------------
+
+// Writes the page tables of the processes and the state of the frames
+void write_paged_mem(out_t *out, paged_mem_t *mem, process_t **live,
+                     size_t n_live) {
+    write_uint(out, mem->faults);
+    write_uint(out, mem->evictions);
+    write_uint(out, mem->hand);
+    write_uint(out, mem->oldest + 1);
+
+    size_t n_tables = 0;
+    for (size_t i = 0; i < n_live; i++) {
+        n_tables += live[i]->mem != NULL;
+    }
+    write_uint(out, n_tables);
+    for (size_t i = 0; i < n_live; i++) {
+        page_table_t *table = (page_table_t *)live[i]->mem;
+        if (!table) {
+            continue;
+        }
+
+        write_uint(out, live[i]->id);
+        write_uint(out, table->len);
+        write_uint(out, table->hole);
+        for (size_t page = 0; page < table->len; page++) {
+            write_uint(out, table->pages[page] + 1);
+        }
+    }
+
+    // Which page is in each frame is known from the tables
+    for (size_t frame = 0; mem->frame_state && frame < mem->n_frames;
+         frame++) {
+        frame_t *state = frame_state(mem, frame);
+        if (!state) {
+            // No frame of the chunk is loaded
+            frame += FRAME_CHUNK - 1;
+            continue;
+        }
+        if (state->table) {
+            write_uint(out, state->referenced);
+            write_uint(out, state->last_used);
+            write_uint(out, state->prev);
+            write_uint(out, state->next);
+        }
+    }
+}
+
+// Reads the page tables of processes and the state of the frames
+void read_paged_mem(ckpt_reader_t *in, paged_mem_t *mem) {
+    mem->faults = read_uint(in);
+    mem->evictions = read_uint(in);
+    mem->hand = read_below(in, mem->n_frames);
+    mem->oldest = (long)read_below(in, mem->n_frames + 1) - 1;
+
+    size_t n_tables = read_uint(in);
+    for (size_t i = 0; i < n_tables && in->cursor; i++) {
+        process_t *p = read_id(in);
+        if (!p || p->mem) {
+            in->cursor = NULL;
+            break;
+        }
+
+        page_table_t *table = page_table_init(mem, p);
+        p->mem = table;
+        size_t len = read_below(in, table->n_pages + 1);
+        page_table_reserve(table, len);
+        table->len = len;
+        table->hole = read_below(in, len + 1);
+
+        // No frame holds more than one page
+        for (size_t page = 0; page < len && in->cursor; page++) {
+            size_t frame = read_below(in, mem->n_frames + 1);
+            if (!frame--) {
+                continue;
+            }
+            if (bitmap_test(mem->frames, frame)) {
+                in->cursor = NULL;
+                break;
+            }
+
+            bitmap_set(mem->frames, frame);
+            table->pages[page] = frame;
+            table->allocated += 1;
+            if (mem->frame_state) {
+                frame_state_alloc(mem, frame)->table = table;
+                frame_state(mem, frame)->page = page;
+            }
+        }
+
+        mem->allocatable -= table->allocated * mem->frame_size;
+        mem->used += table->allocated * mem->frame_size;
+    }
+
+    for (size_t frame = 0; mem->frame_state && frame < mem->n_frames;
+         frame++) {
+        frame_t *state = frame_state(mem, frame);
+        if (!state) {
+            frame += FRAME_CHUNK - 1;
+            continue;
+        }
+        if (!state->table) {
+            continue;
+        }
+
+        state->referenced = read_below(in, 2);
+        state->last_used = read_uint(in);
+        state->prev = read_below(in, mem->n_frames);
+        state->next = read_below(in, mem->n_frames);
+        if (!bitmap_test(mem->frames, state->prev) ||
+            !bitmap_test(mem->frames, state->next)) {
+            in->cursor = NULL;
+        }
+    }
+
+    // The load order starts at the oldest frame, if any frame is loaded
+    if (mem->frame_state &&
+        (mem->oldest == -1 ? mem->frames->n_set != 0
+                           : !bitmap_test(mem->frames, mem->oldest))) {
+        in->cursor = NULL;
+    }
+}
+
+// Frees the page tables given to restored processes, which the scheduler
+// doesn't free as it only frees memory of processes that finish
+void free_page_tables(ckpt_reader_t *in, rr_t *rr) {
+    if (!in->by_id || (rr->mem->type != PAGED && rr->mem->type != VIRTUAL)) {
+        return;
+    }
+
+    for (size_t id = 0; id < in->n_arrived; id++) {
+        process_t *p = in->by_id[id];
+        if (p && p->mem) {
+            page_table_free(rr->mem->data, p->mem);
+            p->mem = NULL;
+        }
+    }
+}
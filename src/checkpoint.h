@@ -0,0 +1,70 @@
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include "config.h"
+#include "roundrobin.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+// Binary checkpoint format
+// -------------------------------------------------------------------------
+// A checkpoint holds the complete state of a scheduler between two cycles,
+// so a simulation restored from it carries on exactly as if it had never
+// stopped. It starts with CHECKPOINT_MAGIC and one byte holding the size of
+// a long double, as the running averages are stored in their native
+// representation. Everything else is an unsigned LEB128 varint, as in traces.
+// Processes that have arrived are referred to by their id
+//
+// Options:    memory type, cores, memory size, frame size, minimum pages,
+//             replacement policy, scheduling policy
+// Scheduler:  time, processes arrived, processes read, next balance time,
+//             processes finished, then the average turnaround, total and
+//             maximum overhead
+// Counters:   number of counters, each counter's value
+// Processes:  count, each arrived process that hasn't finished with its id,
+//             name length, name bytes, arrival, service, remaining, memory
+//             size and virtual runtime
+// Cores:      each core's busy time, migrations, running id + 1 (0 if idle),
+//             least virtual runtime if the scheduling policy is CFS, then
+//             the number of ready processes and their ids in the order they
+//             would run, then the largest free block + 1 when none of them
+//             fit in memory (0 otherwise), followed by the least memory any
+//             of them needs if so
+// LRU:        count, ids least recently used first
+// Pending:    count, each process read but yet to arrive, as above without
+//             an id
+// Memory:     depends on the memory type
+//   FIRST_FIT, SEG_FIT: block count, each block's size and whether it is
+//             allocated, owner count, each owner's id and block start
+//             SEG_FIT adds each size class's length and its blocks' starts
+//             in list order. Both end with the number of compactions and
+//             the memory they moved
+//   BUDDY:    free count, each free block's start and order, owner count,
+//             each owner's id, block start and order
+//   PAGED, VIRTUAL: faults, evictions, CLOCK hand, oldest frame + 1, table
+//             count, each table's owner id, length, hole and frame + 1 of
+//             every entry (0 if not allocated). Replacement policies other
+//             than LRU add each allocated frame's referenced bit, last use
+//             and previous and next frame, in frame order. Frames are
+//             ordered by load, or by last use with WORKING_SET
+//
+// Only the memory options and number of cores have to match to restore a
+// checkpoint, so what-if runs can be forked from it with a different
+// quantum, scheduling policy or balancer
+
+#define CHECKPOINT_MAGIC "RRCKPT04"
+#define CHECKPOINT_MAGIC_LENGTH 8
+
+// Writes a checkpoint of the scheduler's state between two cycles to a file,
+// replacing any previous checkpoint in it. The output written so far is
+// flushed first, so it matches the checkpoint
+// Returns 1 if successful, 0 if the file can't be written
+int checkpoint_save(rr_t *rr, char *filename);
+
+// Creates a scheduler configured by the run options, in the state saved in a
+// checkpoint file
+// Returns NULL if the file can't be read, is corrupt or was saved with other
+// memory options or number of cores
+rr_t *checkpoint_restore(run_opts_t *opts, char *filename);
+
+#endif
@@ -1,19 +1,95 @@
 #ifndef _CONFIG_H_
 #define _CONFIG_H_
 
+#include <stdlib.h>
+
 // Enum definining the different options for memory management
 typedef enum mem_opt {
     INFINITE,
     FIRST_FIT,
     PAGED,
     VIRTUAL,
+    BUDDY,    // Power of two blocks split in halves and merged with buddies
+    SEG_FIT,  // Free blocks kept in lists by size class
 } mem_opt_t;
 
+// Enum defining the different scheduling policies
+typedef enum policy_opt {
+    ROUND_ROBIN,
+    SRTF, // Shortest remaining time first
+    CFS,  // Completely fair, runs the process with the least virtual runtime
+} policy_opt_t;
+
+// Enum defining the different ways of balancing processes between cores
+typedef enum balance_opt {
+    STEAL,    // Idle cores take a process from the core with the most waiting
+    PERIODIC, // Processes are evened out between cores every BALANCE_PERIOD
+} balance_opt_t;
+
+// Enum defining the different ways of picking pages to evict
+typedef enum replace_opt {
+    LRU,           // Pages of the least recently run processes
+    CLOCK,         // Unreferenced frames found by a hand sweeping over memory
+    SECOND_CHANCE, // Unreferenced frames in the order they were loaded
+    WORKING_SET,   // Frames unused for WORKING_SET_WINDOW, then the oldest used
+} replace_opt_t;
+
+// Number of quanta between periodic balancing of processes between cores
+#define BALANCE_PERIOD 10
+
+// Number of quanta a page stays in its process's working set after it's used
+#define WORKING_SET_WINDOW 10
+
+// Default sizes of the simulated memory, in KB
+#define DEFAULT_MEM_SIZE 2048
+#define DEFAULT_FRAME_SIZE 4
+
+// Default number of pages a process needs to run with virtual memory
+#define DEFAULT_MIN_PAGES 4
+
+// Default KB of memory compaction copies per unit of simulated time
+#define DEFAULT_COMPACT_RATE 256
+
+// Default simulated time between checkpoints
+#define DEFAULT_CHECKPOINT_EVERY 1000
+
+// Max number of values a single option can take in a parameter sweep
+#define MAX_SWEEP_VALUES 16
+
+// Struct to hold the values a parameter sweep runs every combination of
+typedef struct sweep_options {
+    mem_opt_t mems[MAX_SWEEP_VALUES];
+    size_t n_mems;
+    int quanta[MAX_SWEEP_VALUES];
+    size_t n_quanta;
+    size_t mem_sizes[MAX_SWEEP_VALUES]; // Sizes of memory in KB
+    size_t n_mem_sizes;
+    size_t threads; // Number of simulations to run at once
+} sweep_opts_t;
+
 // Struct to hold all command line arguments and run options
 typedef struct run_options {
     char *filename;
     mem_opt_t mem;
+    policy_opt_t policy;
     int quantum;
+    size_t cores;          // Number of simulated cores
+    balance_opt_t balance; // How processes are balanced between cores
+    size_t mem_size;   // Size of memory in KB
+    size_t frame_size; // Size of a frame in KB, for paged memory
+    size_t min_pages;  // Pages a process needs to run with virtual memory
+    replace_opt_t replace; // How pages are picked for eviction
+    int report_paging;     // Whether to print page fault and eviction counts
+    int stats;             // Whether to print the hot path counters
+    int compact;           // Whether to compact contiguous memory
+    int compact_threshold; // External fragmentation % compaction starts at
+    size_t compact_rate;   // KB compaction copies per unit of time
+    char *trace_file;    // File to write a binary event trace to, if any
+    char *checkpoint_file;   // File to keep the latest checkpoint in, if any
+    size_t checkpoint_every; // Simulated time between checkpoints
+    char *restore_file;      // Checkpoint to carry on simulating from, if any
+    int quiet;           // Whether to discard events and statistics output
+    sweep_opts_t *sweep; // Values to sweep over, NULL for a single run
 } run_opts_t;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include <assert.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "events.h"
+#include "output.h"
+#include "process.h"
+#include "trace.h"
+
+// Decodes a binary trace written by allocate -t back into allocate's text
+// output, written to stdout
+
+// Struct holding the state of a trace being decoded
+typedef struct decoder {
+    const uint8_t *cursor;
+    const uint8_t *end;
+    mem_opt_t mem;
+    size_t n_cores; // RUNNING records only name a core if there are several
+    size_t time;
+    char (*names)[NAME_MAX_LENGTH + 1]; // Process names in arrival order
+    size_t *ids; // Id of each named process, increasing as they arrive
+    size_t n_names;
+    size_t names_cap;
+    long *frames; // Buffer for the current record's frame list
+    size_t frames_cap;
+} decoder_t;
+
+// Decodes the next varint of the trace, failing on a truncated trace
+uint64_t decode_varint(decoder_t *d);
+
+// Decodes a record's time difference, returning the record's time
+size_t decode_time(decoder_t *d);
+
+// Decodes a frame list into the decoder's frame buffer
+// Returns the number of frames
+size_t decode_frames(decoder_t *d);
+
+// Decodes an 8 byte little endian double
+double decode_double(decoder_t *d);
+
+// Adds a process to the arrived processes, failing unless its id is greater
+// than any before it, so corrupt ids can't grow the name table unbounded
+// Returns the buffer for its name
+char *decode_arrival(decoder_t *d, size_t id);
+
+// Returns the name of the arrived process with the given id, failing if no
+// process with that id has arrived
+char *decode_name(decoder_t *d, size_t id);
+
+// Prints an error message to stderr and exits the process with an error
+void decode_fail(char *message);
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <trace file>\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    if (fd < 0) {
+        decode_fail("cannot open trace file");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        decode_fail("cannot stat trace file");
+    }
+    if ((size_t)st.st_size < TRACE_MAGIC_LENGTH + 1) {
+        decode_fail("not a trace file");
+    }
+
+    const uint8_t *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        decode_fail("cannot map trace file");
+    }
+    madvise((void *)data, st.st_size, MADV_SEQUENTIAL);
+
+    if (memcmp(data, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0) {
+        decode_fail("not a trace file");
+    }
+
+    decoder_t d;
+    d.cursor = data + TRACE_MAGIC_LENGTH + 1;
+    d.end = data + st.st_size;
+    d.mem = data[TRACE_MAGIC_LENGTH];
+    d.n_cores = 1;
+    d.time = 0;
+    d.names = NULL;
+    d.ids = NULL;
+    d.n_names = 0;
+    d.names_cap = 0;
+    d.frames_cap = 64;
+    d.frames = malloc(sizeof(*d.frames) * d.frames_cap);
+    assert(d.frames);
+
+    out_t *out = new_output(stdout);
+
+    while (d.cursor < d.end) {
+        trace_record_t type = *d.cursor++;
+        size_t time, id, remaining, n_frames, migrations, faults, evictions,
+            moved, copy_time, compactions;
+        int usage = 0, internal_frag = 0, external_frag = 0;
+        long allocated_at = 0, core;
+        double turnaround, max_overhead, avg_overhead, utilisation;
+
+        switch (type) {
+        case TRACE_ARRIVAL:
+            id = decode_varint(&d);
+            size_t len = decode_varint(&d);
+            if (len > NAME_MAX_LENGTH || len > (size_t)(d.end - d.cursor)) {
+                decode_fail("corrupt trace");
+            }
+            char *name = decode_arrival(&d, id);
+            memcpy(name, d.cursor, len);
+            name[len] = '\0';
+            d.cursor += len;
+            break;
+
+        case TRACE_RUNNING:
+            time = decode_time(&d);
+            id = decode_varint(&d);
+            remaining = decode_varint(&d);
+            n_frames = 0;
+            if (d.mem == FIRST_FIT) {
+                usage = decode_varint(&d);
+                allocated_at = decode_varint(&d);
+            } else if (d.mem == BUDDY || d.mem == SEG_FIT) {
+                usage = decode_varint(&d);
+                allocated_at = decode_varint(&d);
+                internal_frag = decode_varint(&d);
+                external_frag = decode_varint(&d);
+            } else if (d.mem == PAGED || d.mem == VIRTUAL) {
+                usage = decode_varint(&d);
+                n_frames = decode_frames(&d);
+            }
+            core = d.n_cores > 1 ? (long)decode_varint(&d) : -1;
+            print_running(out, time, decode_name(&d, id), remaining, d.mem,
+                          usage, allocated_at, internal_frag, external_frag,
+                          d.frames, n_frames, core);
+            break;
+
+        case TRACE_FINISHED:
+            time = decode_time(&d);
+            id = decode_varint(&d);
+            remaining = decode_varint(&d);
+            print_finished(out, time, decode_name(&d, id), remaining);
+            break;
+
+        case TRACE_EVICTED:
+            time = decode_time(&d);
+            n_frames = decode_frames(&d);
+            print_evicted(out, time, d.frames, n_frames);
+            break;
+
+        case TRACE_COMPACTED:
+            time = decode_time(&d);
+            moved = decode_varint(&d);
+            copy_time = decode_varint(&d);
+            print_compacted(out, time, moved, copy_time);
+            break;
+
+        case TRACE_SUMMARY:
+            time = decode_time(&d);
+            turnaround = decode_double(&d);
+            max_overhead = decode_double(&d);
+            avg_overhead = decode_double(&d);
+            print_summary(out, turnaround, max_overhead, avg_overhead, time);
+            break;
+
+        case TRACE_CORES:
+            d.n_cores = decode_varint(&d);
+            break;
+
+        case TRACE_CORE_SUMMARY:
+            id = decode_varint(&d);
+            migrations = decode_varint(&d);
+            utilisation = decode_double(&d);
+            print_core_summary(out, id, utilisation, migrations);
+            break;
+
+        case TRACE_PAGING:
+            faults = decode_varint(&d);
+            evictions = decode_varint(&d);
+            print_paging_summary(out, faults, evictions);
+            break;
+
+        case TRACE_COMPACTION:
+            compactions = decode_varint(&d);
+            moved = decode_varint(&d);
+            print_compaction_summary(out, compactions, moved);
+            break;
+
+        default:
+            decode_fail("corrupt trace");
+        }
+    }
+
+    out_free(out);
+    free(d.names);
+    free(d.ids);
+    free(d.frames);
+    munmap((void *)data, st.st_size);
+    close(fd);
+
+    exit(EXIT_SUCCESS);
+}
+
+// Decodes the next varint of the trace, failing on a truncated trace
+uint64_t decode_varint(decoder_t *d) {
+    uint64_t value = varint_decode(&d->cursor, d->end);
+    if (!d->cursor) {
+        decode_fail("truncated trace");
+    }
+    return value;
+}
+
+// Decodes a record's time difference, returning the record's time
+size_t decode_time(decoder_t *d) {
+    d->time += decode_varint(d);
+    return d->time;
+}
+
+// Decodes a frame list into the decoder's frame buffer
+// Returns the number of frames
+size_t decode_frames(decoder_t *d) {
+    size_t n = decode_varint(d);
+
+    // Every frame takes at least a byte
+    if (n > (size_t)(d->end - d->cursor)) {
+        decode_fail("corrupt trace");
+    }
+
+    if (n > d->frames_cap) {
+        d->frames_cap = n;
+        d->frames = realloc(d->frames, sizeof(*d->frames) * d->frames_cap);
+        assert(d->frames);
+    }
+
+    int64_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t zigzag = decode_varint(d);
+        prev += (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        d->frames[i] = prev;
+    }
+
+    return n;
+}
+
+// Decodes an 8 byte little endian double
+double decode_double(decoder_t *d) {
+    if (d->end - d->cursor < 8) {
+        decode_fail("truncated trace");
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits |= (uint64_t)d->cursor[i] << (8 * i);
+    }
+    d->cursor += 8;
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Adds a process to the arrived processes, failing unless its id is greater
+// than any before it, so corrupt ids can't grow the name table unbounded
+// Returns the buffer for its name
+char *decode_arrival(decoder_t *d, size_t id) {
+    if (d->n_names > 0 && id <= d->ids[d->n_names - 1]) {
+        decode_fail("corrupt trace");
+    }
+
+    if (d->n_names >= d->names_cap) {
+        d->names_cap = d->names_cap ? d->names_cap * 2 : 64;
+        d->names = realloc(d->names, sizeof(*d->names) * d->names_cap);
+        assert(d->names);
+        d->ids = realloc(d->ids, sizeof(*d->ids) * d->names_cap);
+        assert(d->ids);
+    }
+
+    d->ids[d->n_names] = id;
+    return d->names[d->n_names++];
+}
+
+// Returns the name of the arrived process with the given id, failing if no
+// process with that id has arrived
+char *decode_name(decoder_t *d, size_t id) {
+    // Ids are dense unless the trace was restored from a checkpoint, when
+    // only processes alive at the checkpoint are named
+    if (id < d->n_names && d->ids[id] == id) {
+        return d->names[id];
+    }
+
+    size_t low = 0, high = d->n_names;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (d->ids[mid] < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low >= d->n_names || d->ids[low] != id) {
+        decode_fail("corrupt trace");
+    }
+
+    return d->names[low];
+}
+
+// Prints an error message to stderr and exits the process with an error
+void decode_fail(char *message) {
+    fprintf(stderr, "decode: %s\n", message);
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,137 @@
+#include "events.h"
+#include <stdlib.h>
+
+// Prints a RUNNING event
+// usage and allocated_at are only printed for memory types that use them,
+// fragmentation only for the buddy and segregated fit memory types, frames
+// only for paged memory types and core is only printed if it isn't -1
+void print_running(out_t *out, size_t time, const char *name,
+                   size_t remaining, mem_opt_t mem, int usage,
+                   long allocated_at, int internal_frag, int external_frag,
+                   long *frames, size_t n_frames, long core) {
+    out_uint(out, time);
+    out_str(out, ",RUNNING,process-name=");
+    out_str(out, name);
+    out_str(out, ",remaining-time=");
+    out_uint(out, remaining);
+
+    switch (mem) {
+    case FIRST_FIT:
+        out_str(out, ",mem-usage=");
+        out_int(out, usage);
+        out_str(out, "%,allocated-at=");
+        out_int(out, allocated_at);
+        break;
+    case BUDDY:
+    case SEG_FIT:
+        out_str(out, ",mem-usage=");
+        out_int(out, usage);
+        out_str(out, "%,allocated-at=");
+        out_int(out, allocated_at);
+        out_str(out, ",internal-frag=");
+        out_int(out, internal_frag);
+        out_str(out, "%,external-frag=");
+        out_int(out, external_frag);
+        out_char(out, '%');
+        break;
+    case PAGED:
+    case VIRTUAL:
+        out_str(out, ",mem-usage=");
+        out_int(out, usage);
+        out_str(out, "%,mem-frames=[");
+        print_frames(out, frames, n_frames);
+        out_char(out, ']');
+        break;
+    case INFINITE:
+        break;
+    }
+
+    if (core != -1) {
+        out_str(out, ",core=");
+        out_int(out, core);
+    }
+
+    out_char(out, '\n');
+}
+
+// Prints a FINISHED event
+void print_finished(out_t *out, size_t time, const char *name,
+                    size_t proc_remaining) {
+    out_uint(out, time);
+    out_str(out, ",FINISHED,process-name=");
+    out_str(out, name);
+    out_str(out, ",proc-remaining=");
+    out_uint(out, proc_remaining);
+    out_char(out, '\n');
+}
+
+// Prints an EVICTED event
+void print_evicted(out_t *out, size_t time, long *frames, size_t n_frames) {
+    out_uint(out, time);
+    out_str(out, ",EVICTED,evicted-frames=[");
+    print_frames(out, frames, n_frames);
+    out_str(out, "]\n");
+}
+
+// Prints a COMPACTED event, for memory compacted by moving the given amount of
+// allocated memory in KB over copy_time
+void print_compacted(out_t *out, size_t time, size_t moved, size_t copy_time) {
+    out_uint(out, time);
+    out_str(out, ",COMPACTED,mem-moved=");
+    out_uint(out, moved);
+    out_str(out, "KB,copy-time=");
+    out_uint(out, copy_time);
+    out_char(out, '\n');
+}
+
+// Prints the summary statistics of a finished simulation
+void print_summary(out_t *out, double turnaround, double max_overhead,
+                   double avg_overhead, size_t makespan) {
+    out_printf(out, "Turnaround time %.0f\n", turnaround);
+    out_printf(out, "Time overhead %.2f %.2f\n", max_overhead, avg_overhead);
+    out_str(out, "Makespan ");
+    out_uint(out, makespan);
+    out_char(out, '\n');
+}
+
+// Prints the statistics of one core of a finished simulation
+void print_core_summary(out_t *out, size_t core, double utilisation,
+                        size_t migrations) {
+    out_str(out, "Core ");
+    out_uint(out, core);
+    out_printf(out, " utilisation %.2f%% migrations ", utilisation);
+    out_uint(out, migrations);
+    out_char(out, '\n');
+}
+
+// Prints the page faults and evictions of a finished simulation
+void print_paging_summary(out_t *out, size_t faults, size_t evictions) {
+    out_str(out, "Page faults ");
+    out_uint(out, faults);
+    out_str(out, " evictions ");
+    out_uint(out, evictions);
+    out_char(out, '\n');
+}
+
+// Prints the number of compactions of a finished simulation and the memory
+// they moved in KB
+void print_compaction_summary(out_t *out, size_t compactions, size_t moved) {
+    out_str(out, "Compactions ");
+    out_uint(out, compactions);
+    out_str(out, " moved ");
+    out_uint(out, moved);
+    out_str(out, "KB\n");
+}
+
+// Prints a comma separated list of frames, skipping unallocated (-1) frames
+void print_frames(out_t *out, long *frames, size_t n_frames) {
+    int first = 1;
+    for (size_t i = 0; i < n_frames; i++) {
+        if (frames[i] == -1) {
+            continue;
+        }
+
+        first ? first = 0 : out_char(out, ',');
+        out_uint(out, frames[i]);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef _EVENTS_H_
+#define _EVENTS_H_
+
+#include "config.h"
+#include "output.h"
+#include <stdlib.h>
+
+// Text formatting of the scheduler's events and summary statistics
+// Shared by the scheduler and the trace decoder so both print identical text
+
+// Prints a RUNNING event
+// usage and allocated_at are only printed for memory types that use them,
+// fragmentation only for the buddy and segregated fit memory types, frames
+// only for paged memory types and core is only printed if it isn't -1
+void print_running(out_t *out, size_t time, const char *name,
+                   size_t remaining, mem_opt_t mem, int usage,
+                   long allocated_at, int internal_frag, int external_frag,
+                   long *frames, size_t n_frames, long core);
+
+// Prints a FINISHED event
+void print_finished(out_t *out, size_t time, const char *name,
+                    size_t proc_remaining);
+
+// Prints an EVICTED event
+void print_evicted(out_t *out, size_t time, long *frames, size_t n_frames);
+
+// Prints a COMPACTED event, for memory compacted by moving the given amount of
+// allocated memory in KB over copy_time
+void print_compacted(out_t *out, size_t time, size_t moved, size_t copy_time);
+
+// Prints the summary statistics of a finished simulation
+void print_summary(out_t *out, double turnaround, double max_overhead,
+                   double avg_overhead, size_t makespan);
+
+// Prints the statistics of one core of a finished simulation
+void print_core_summary(out_t *out, size_t core, double utilisation,
+                        size_t migrations);
+
+// Prints the page faults and evictions of a finished simulation
+void print_paging_summary(out_t *out, size_t faults, size_t evictions);
+
+// Prints the number of compactions of a finished simulation and the memory
+// they moved in KB
+void print_compaction_summary(out_t *out, size_t compactions, size_t moved);
+
+// Prints a comma separated list of frames, skipping unallocated (-1) frames
+void print_frames(out_t *out, long *frames, size_t n_frames);
+
+#endif
@@ -0,0 +1,267 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Generates synthetic process files for allocate, written to stdout in
+// arrival order
+
+#define OPT_STRING ":n:a:i:t:s:m:x:"
+
+// Mean number of processes arriving together in a burst
+#define BURST_SIZE 8
+
+// Shape of the Pareto service time tail, smaller is heavier
+#define PARETO_SHAPE 1.5
+
+// Longest service time generated, as a multiple of the mean
+#define MAX_SERVICE_MEANS 1000
+
+// Max number of sizes in a memory mix
+#define MAX_MIX_SIZES 16
+
+// Memory sizes generated when no mix is given, in KB, with their weights
+#define DEFAULT_MIX "16:4,64:3,256:2,1024:1"
+
+// Enum defining the ways processes can arrive
+typedef enum arrival_opt {
+    POISSON, // Exponentially distributed gaps between processes
+    BURSTY,  // Bursts of processes arriving at once, with Poisson bursts
+} arrival_opt_t;
+
+// Enum defining the distributions of service times
+typedef enum service_opt {
+    EXPONENTIAL,
+    PARETO, // Heavy tailed
+} service_opt_t;
+
+// Struct to hold the generator's options
+typedef struct gen_options {
+    size_t n_processes;
+    arrival_opt_t arrival;
+    double interarrival; // Mean time between arrivals
+    service_opt_t service;
+    double mean_service;
+    size_t sizes[MAX_MIX_SIZES]; // Memory sizes in KB
+    double weights[MAX_MIX_SIZES];
+    size_t n_sizes;
+    uint64_t seed;
+} gen_opts_t;
+
+// Parses generator options from the command line
+void parse_gen_options(int argc, char **argv, gen_opts_t *opts);
+
+// Parses a memory mix of size:weight pairs, failing the parse if it isn't one
+void parse_mix(char *mix, gen_opts_t *opts, char *process_name);
+
+// Prints an error message to stderr and exits the process with an error
+void gen_fail(char *process_name);
+
+// Returns the next random 64-bit number of the generator's state
+// xorshift64*, so workloads are the same on every platform
+uint64_t next_random(uint64_t *state);
+
+// Returns a random double in (0, 1]
+double uniform(uint64_t *state);
+
+// Returns an exponentially distributed random double with the given mean
+double exponential(uint64_t *state, double mean);
+
+// Returns a random service time of at least 1
+size_t random_service(uint64_t *state, gen_opts_t *opts);
+
+// Returns a random memory size drawn from the memory mix
+size_t random_size(uint64_t *state, gen_opts_t *opts);
+
+int main(int argc, char **argv) {
+    gen_opts_t opts;
+    parse_gen_options(argc, argv, &opts);
+
+    uint64_t state = opts.seed;
+    double time = 0;
+    size_t burst = 0; // Processes left to arrive in the current burst
+
+    for (size_t i = 0; i < opts.n_processes; i++) {
+        if (opts.arrival == POISSON) {
+            time += exponential(&state, opts.interarrival);
+        } else if (burst-- == 0) {
+            // Space bursts out so processes arrive at the same mean rate
+            time += exponential(&state, opts.interarrival * BURST_SIZE);
+            burst = exponential(&state, BURST_SIZE);
+        }
+
+        printf("%zu P%zu %zu %zu\n", (size_t)time, i,
+               random_service(&state, &opts), random_size(&state, &opts));
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+// Parses generator options from the command line
+void parse_gen_options(int argc, char **argv, gen_opts_t *opts) {
+    int c;
+    int n_flag = 0;
+    char default_mix[] = DEFAULT_MIX;
+
+    // Optional arguments
+    opts->arrival = POISSON;
+    opts->interarrival = 2;
+    opts->service = EXPONENTIAL;
+    opts->mean_service = 10;
+    opts->seed = 1;
+    opts->n_sizes = 0;
+
+    while ((c = getopt(argc, argv, OPT_STRING)) != -1) {
+        switch (c) {
+        case 'n': // Read the number of processes
+            n_flag++;
+            opts->n_processes = strtoull(optarg, NULL, 10);
+            break;
+
+        case 'a': // Read how processes arrive
+            if (strcmp(optarg, "poisson") == 0) {
+                opts->arrival = POISSON;
+            } else if (strcmp(optarg, "bursty") == 0) {
+                opts->arrival = BURSTY;
+            } else {
+                gen_fail(argv[0]);
+            }
+            break;
+
+        case 'i': // Read the mean time between arrivals
+            opts->interarrival = atof(optarg);
+            if (opts->interarrival < 0) {
+                gen_fail(argv[0]);
+            }
+            break;
+
+        case 't': // Read the service time distribution
+            if (strcmp(optarg, "exponential") == 0) {
+                opts->service = EXPONENTIAL;
+            } else if (strcmp(optarg, "pareto") == 0) {
+                opts->service = PARETO;
+            } else {
+                gen_fail(argv[0]);
+            }
+            break;
+
+        case 's': // Read the mean service time
+            opts->mean_service = atof(optarg);
+            if (opts->mean_service < 1) {
+                gen_fail(argv[0]);
+            }
+            break;
+
+        case 'm': // Read the memory mix
+            parse_mix(optarg, opts, argv[0]);
+            break;
+
+        case 'x': // Read the random seed
+            // xorshift never leaves a zero state
+            opts->seed = strtoull(optarg, NULL, 10) | 1;
+            break;
+
+        default: // Not a supported flag
+            gen_fail(argv[0]);
+        }
+    }
+
+    if (n_flag != 1 || opts->n_processes < 1) {
+        gen_fail(argv[0]);
+    }
+
+    if (opts->n_sizes == 0) {
+        parse_mix(default_mix, opts, argv[0]);
+    }
+}
+
+// Parses a memory mix of size:weight pairs, failing the parse if it isn't one
+void parse_mix(char *mix, gen_opts_t *opts, char *process_name) {
+    opts->n_sizes = 0;
+
+    for (char *pair = strtok(mix, ","); pair; pair = strtok(NULL, ",")) {
+        size_t size;
+        double weight;
+        if (opts->n_sizes >= MAX_MIX_SIZES ||
+            sscanf(pair, "%zu:%lf", &size, &weight) != 2 || size < 1 ||
+            weight <= 0) {
+            gen_fail(process_name);
+        }
+
+        opts->sizes[opts->n_sizes] = size;
+        opts->weights[opts->n_sizes] = weight;
+        opts->n_sizes++;
+    }
+
+    if (opts->n_sizes == 0) {
+        gen_fail(process_name);
+    }
+}
+
+// Prints an error message to stderr and exits the process with an error
+void gen_fail(char *process_name) {
+    fprintf(stderr,
+            "Usage: %s -n <processes> [-a (poisson | bursty)] "
+            "[-i <mean interarrival time>] [-t (exponential | pareto)] "
+            "[-s <mean service time>] [-m <KB>:<weight>[,<KB>:<weight>...]] "
+            "[-x <seed>]\n",
+            process_name);
+    exit(EXIT_FAILURE);
+}
+
+// Returns the next random 64-bit number of the generator's state
+// xorshift64*, so workloads are the same on every platform
+uint64_t next_random(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545f4914f6cdd1dULL;
+}
+
+// Returns a random double in (0, 1]
+double uniform(uint64_t *state) {
+    return ((next_random(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Returns an exponentially distributed random double with the given mean
+double exponential(uint64_t *state, double mean) {
+    return -mean * log(uniform(state));
+}
+
+// Returns a random service time of at least 1
+size_t random_service(uint64_t *state, gen_opts_t *opts) {
+    double service;
+
+    if (opts->service == PARETO) {
+        // Scale chosen so the distribution has the requested mean
+        double scale = opts->mean_service * (PARETO_SHAPE - 1) / PARETO_SHAPE;
+        service = scale / pow(uniform(state), 1 / PARETO_SHAPE);
+    } else {
+        service = exponential(state, opts->mean_service);
+    }
+
+    if (service > opts->mean_service * MAX_SERVICE_MEANS) {
+        service = opts->mean_service * MAX_SERVICE_MEANS;
+    }
+    return service < 1 ? 1 : (size_t)service;
+}
+
+// Returns a random memory size drawn from the memory mix
+size_t random_size(uint64_t *state, gen_opts_t *opts) {
+    double total = 0;
+    for (size_t i = 0; i < opts->n_sizes; i++) {
+        total += opts->weights[i];
+    }
+
+    double pick = uniform(state) * total;
+    for (size_t i = 0; i < opts->n_sizes; i++) {
+        pick -= opts->weights[i];
+        if (pick <= 0) {
+            return opts->sizes[i];
+        }
+    }
+
+    return opts->sizes[opts->n_sizes - 1];
+}
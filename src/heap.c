@@ -0,0 +1,123 @@
+#include "heap.h"
+#include "stats.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initial number of elements a heap has room for
+#define INITIAL_HEAP_CAP 64
+
+#define PARENT(i) (((i) - 1) / 2)
+#define LEFT(i) (2 * (i) + 1)
+
+// Returns whether entry a comes before entry b in the heap's order
+int heap_before(heap_entry_t *a, heap_entry_t *b);
+
+// Orders heap entries the way they would be popped
+int heap_entry_cmp(const void *a, const void *b);
+
+// Creates and returns a new empty heap
+heap_t *new_heap() {
+    heap_t *heap = malloc(sizeof(*heap));
+    assert(heap);
+
+    heap->len = 0;
+    heap->cap = INITIAL_HEAP_CAP;
+    heap->next_seq = 0;
+    heap->entries = malloc(sizeof(*heap->entries) * heap->cap);
+    assert(heap->entries);
+
+    return heap;
+}
+
+// Adds an element with the given key to the heap
+void heap_push(heap_t *heap, size_t key, void *data) {
+    if (heap->len >= heap->cap) {
+        heap->cap *= 2;
+        heap->entries =
+            realloc(heap->entries, sizeof(*heap->entries) * heap->cap);
+        assert(heap->entries);
+        STAT_INC(mallocs);
+    }
+
+    heap_entry_t entry = {key, heap->next_seq++, data};
+
+    // Sift the hole up from the end until the entry's parent comes before it
+    size_t i = heap->len++;
+    while (i > 0 && heap_before(&entry, &heap->entries[PARENT(i)])) {
+        heap->entries[i] = heap->entries[PARENT(i)];
+        i = PARENT(i);
+    }
+    heap->entries[i] = entry;
+}
+
+// Removes and returns the element with the smallest key
+// Returns NULL if the heap is empty
+void *heap_pop(heap_t *heap) {
+    if (heap->len < 1) {
+        return NULL;
+    }
+
+    void *data = heap->entries[0].data;
+    heap_entry_t last = heap->entries[--heap->len];
+
+    // Sift the hole down from the root until the last entry fits in it
+    size_t i = 0;
+    size_t child;
+    while ((child = LEFT(i)) < heap->len) {
+        if (child + 1 < heap->len &&
+            heap_before(&heap->entries[child + 1], &heap->entries[child])) {
+            child++;
+        }
+        if (!heap_before(&heap->entries[child], &last)) {
+            break;
+        }
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    heap->entries[i] = last;
+
+    return data;
+}
+
+// Returns the element with the smallest key without removing it
+// Returns NULL if the heap is empty
+void *heap_peek(heap_t *heap) {
+    return heap->len > 0 ? heap->entries[0].data : NULL;
+}
+
+// Returns the smallest key in the heap, the heap must not be empty
+size_t heap_min_key(heap_t *heap) {
+    return heap->entries[0].key;
+}
+
+// Writes the heap's elements to out in the order they would be popped, leaving
+// the heap untouched
+void heap_sorted(heap_t *heap, void **out) {
+    heap_entry_t *entries = malloc(sizeof(*entries) * (heap->len + 1));
+    assert(entries);
+    memcpy(entries, heap->entries, sizeof(*entries) * heap->len);
+    qsort(entries, heap->len, sizeof(*entries), heap_entry_cmp);
+
+    for (size_t i = 0; i < heap->len; i++) {
+        out[i] = entries[i].data;
+    }
+    free(entries);
+}
+
+// Frees the heap, leaving the data it holds untouched
+void heap_free(heap_t *heap) {
+    free(heap->entries);
+    free(heap);
+}
+
+// Returns whether entry a comes before entry b in the heap's order
+int heap_before(heap_entry_t *a, heap_entry_t *b) {
+    return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+// Orders heap entries the way they would be popped
+int heap_entry_cmp(const void *a, const void *b) {
+    heap_entry_t *x = (heap_entry_t *)a, *y = (heap_entry_t *)b;
+    return heap_before(x, y) ? -1 : heap_before(y, x);
+}
@@ -0,0 +1,46 @@
+#ifndef _HEAP_H_
+#define _HEAP_H_
+
+#include <stdlib.h>
+
+// Struct for an element of a heap
+typedef struct heap_entry {
+    size_t key;
+    size_t seq; // Order the element was pushed in, breaks ties between keys
+    void *data;
+} heap_entry_t;
+
+// Struct for a binary min-heap ordered by key
+// Elements with equal keys are popped in the order they were pushed
+typedef struct heap {
+    heap_entry_t *entries;
+    size_t len;
+    size_t cap;
+    size_t next_seq; // Sequence number of the next element pushed
+} heap_t;
+
+// Creates and returns a new empty heap
+heap_t *new_heap();
+
+// Adds an element with the given key to the heap
+void heap_push(heap_t *heap, size_t key, void *data);
+
+// Removes and returns the element with the smallest key
+// Returns NULL if the heap is empty
+void *heap_pop(heap_t *heap);
+
+// Returns the element with the smallest key without removing it
+// Returns NULL if the heap is empty
+void *heap_peek(heap_t *heap);
+
+// Returns the smallest key in the heap, the heap must not be empty
+size_t heap_min_key(heap_t *heap);
+
+// Writes the heap's elements to out in the order they would be popped, leaving
+// the heap untouched
+void heap_sorted(heap_t *heap, void **out);
+
+// Frees the heap, leaving the data it holds untouched
+void heap_free(heap_t *heap);
+
+#endif
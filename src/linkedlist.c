@@ -1,20 +1,48 @@
 
 #include "linkedlist.h"
+#include "stats.h"
 #include <assert.h>
 #include <stdlib.h>
 
 // Creates and returns a new empty list
 list_t *new_list() {
+    return new_pooled_list(NULL);
+}
+
+// Creates and returns a new empty list allocating its nodes from pool
+list_t *new_pooled_list(pool_t *pool) {
     list_t *l = malloc(sizeof(*l));
     assert(l);
 
     l->head = NULL;
     l->tail = NULL;
     l->len = 0;
+    l->pool = pool;
 
     return l;
 }
 
+// Allocates a node for the provided list
+node_t *list_node_alloc(list_t *list) {
+    if (list->pool) {
+        return pool_alloc(list->pool);
+    }
+
+    node_t *node = malloc(sizeof(*node));
+    assert(node);
+    STAT_INC(mallocs);
+    return node;
+}
+
+// Frees a node that belonged to the provided list
+void list_node_free(list_t *list, node_t *node) {
+    if (list->pool) {
+        pool_release(list->pool, node);
+    } else {
+        free(node);
+    }
+}
+
 // Removes the data at the head of the provided list
 // Returns a pointer to the data
 void *list_remove_head(list_t *list) {
@@ -35,15 +63,38 @@ void *list_remove_head(list_t *list) {
 
     list->len -= 1;
 
-    free(node);
+    list_node_free(list, node);
+
+    return data;
+}
+
+// Removes a node from the provided list
+// Returns a pointer to the node's data
+void *list_remove(list_t *list, node_t *node) {
+    void *data = node->data;
+
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        list->head = node->next;
+    }
+
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        list->tail = node->prev;
+    }
+
+    list->len -= 1;
+    list_node_free(list, node);
 
     return data;
 }
 
 // Adds data to the tail of the provided list
-void list_add_tail(list_t *list, void *data) {
-    node_t *new = malloc(sizeof(*new));
-    assert(new);
+// Returns the node holding the data
+node_t *list_add_tail(list_t *list, void *data) {
+    node_t *new = list_node_alloc(list);
 
     new->data = data;
     new->next = NULL;
@@ -53,24 +104,49 @@ void list_add_tail(list_t *list, void *data) {
         // First element in the list
         list->head = list->tail = new;
         list->len = 1;
-        return;
+        return new;
     }
 
     new->prev = list->tail;
     list->tail->next = new;
     list->tail = new;
     list->len += 1;
+
+    return new;
+}
+
+// Moves a node of the provided list to its tail
+void list_move_tail(list_t *list, node_t *node) {
+    // Node is already at the tail, nothing to do
+    if (list->tail == node) {
+        return;
+    }
+
+    // Unlink the node, it has a next node as it isn't the tail
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        list->head = node->next;
+    }
+    node->next->prev = node->prev;
+
+    node->prev = list->tail;
+    node->next = NULL;
+    list->tail->next = node;
+    list->tail = node;
 }
 
 // Frees the list and all remaining data in it using the provided data_free
-// function
+// function, or leaves the data untouched if data_free is NULL
 void list_free(list_t *l, void (*data_free)(void *data)) {
     node_t *curr = l->head;
     while (curr) {
         node_t *prev = curr;
-        data_free(curr->data);
+        if (data_free) {
+            data_free(curr->data);
+        }
         curr = curr->next;
-        free(prev);
+        list_node_free(l, prev);
     }
     free(l);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef _LINKED_LIST_H
 #define _LINKED_LIST_H
 
+#include "pool.h"
 #include <stdlib.h>
 
 typedef struct node node_t;
@@ -17,20 +18,38 @@ typedef struct list {
     node_t *head;
     node_t *tail;
     size_t len;
+    pool_t *pool; // Pool to allocate nodes from, NULL to use malloc
 } list_t;
 
 // Creates and returns a new empty list
 list_t *new_list();
 
+// Creates and returns a new empty list allocating its nodes from pool
+list_t *new_pooled_list(pool_t *pool);
+
+// Allocates a node for the provided list
+node_t *list_node_alloc(list_t *list);
+
+// Frees a node that belonged to the provided list
+void list_node_free(list_t *list, node_t *node);
+
 // Removes the data at the head of the provided list
 // Returns a pointer to the data
 void *list_remove_head(list_t *list);
 
+// Removes a node from the provided list
+// Returns a pointer to the node's data
+void *list_remove(list_t *list, node_t *node);
+
 // Adds data to the tail of the provided list
-void list_add_tail(list_t *list, void *data);
+// Returns the node holding the data
+node_t *list_add_tail(list_t *list, void *data);
+
+// Moves a node of the provided list to its tail
+void list_move_tail(list_t *list, node_t *node);
 
 // Frees the list and all remaining data in it using the provided data_free
-// function
+// function, or leaves the data untouched if data_free is NULL
 void list_free(list_t *l, void (*data_free)(void *data));
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "loader.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Parsed parts of the file are released from memory in chunks of this size,
+// so streaming a file never keeps more than this much of it resident
+#define RELEASE_CHUNK (16 * 1024 * 1024)
+
+// Opens and maps a process file for reading
+// Returns NULL if the file cannot be opened or mapped
+loader_t *loader_open(char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    // Empty files can't be mapped, and have no processes anyway
+    void *data = NULL;
+    if (st.st_size > 0) {
+        data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+    }
+
+    loader_t *loader = malloc(sizeof(*loader));
+    assert(loader);
+
+    loader->fd = fd;
+    loader->size = st.st_size;
+    loader->pos = 0;
+    loader->released = 0;
+    loader->data = data;
+
+    return loader;
+}
+
+// Parses the next process in the file, allocating it from pool
+// Returns NULL once every process has been read
+process_t *loader_next(loader_t *loader, pool_t *pool) {
+    while (loader->pos < loader->size) {
+        const char *line = loader->data + loader->pos;
+        const char *end = memchr(line, '\n', loader->size - loader->pos);
+        if (!end) {
+            // Last line has no trailing new line
+            end = loader->data + loader->size;
+        }
+        loader->pos = end - loader->data + 1;
+
+        // Drop pages that have been fully parsed, names are copied out so
+        // nothing points into them
+        if (loader->pos - loader->released >= RELEASE_CHUNK) {
+            size_t page = sysconf(_SC_PAGESIZE);
+            size_t upto = (end - loader->data) / page * page;
+            madvise((void *)(loader->data + loader->released),
+                    upto - loader->released, MADV_DONTNEED);
+            loader->released = upto;
+        }
+
+        // Skip blank lines
+        const char *c = line;
+        while (c < end && (*c == ' ' || *c == '\t' || *c == '\r')) {
+            c++;
+        }
+        if (c == end) {
+            continue;
+        }
+
+        return parse_process(line, end, pool);
+    }
+
+    return NULL;
+}
+
+// Unmaps and closes the process file
+void loader_close(loader_t *loader) {
+    if (loader->data) {
+        munmap((void *)loader->data, loader->size);
+    }
+    close(loader->fd);
+    free(loader);
+}
@@ -0,0 +1,29 @@
+#ifndef _LOADER_H_
+#define _LOADER_H_
+
+#include "pool.h"
+#include "process.h"
+#include <stdlib.h>
+
+// Struct for reading processes from a memory-mapped process file
+// Lines are parsed in place, without being copied out of the mapping
+typedef struct loader {
+    int fd;
+    const char *data; // The mapped file, NULL if the file is empty
+    size_t size;
+    size_t pos;      // Offset of the next line to parse
+    size_t released; // Offset up to which parsed pages have been released
+} loader_t;
+
+// Opens and maps a process file for reading
+// Returns NULL if the file cannot be opened or mapped
+loader_t *loader_open(char *filename);
+
+// Parses the next process in the file, allocating it from pool
+// Returns NULL once every process has been read
+process_t *loader_next(loader_t *loader, pool_t *pool);
+
+// Unmaps and closes the process file
+void loader_close(loader_t *loader);
+
+#endif
@@ -1,14 +1,43 @@
 #include <assert.h>
+#include <errno.h>
+#include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "checkpoint.h"
 #include "config.h"
+#include "loader.h"
+#include "policy.h"
 #include "process.h"
 #include "roundrobin.h"
+#include "sweep.h"
+#include "workload.h"
 
-#define OPT_STRING ":f:m:q:"
+#define OPT_STRING ":f:m:q:s:c:b:t:Sj:M:P:R:r:"
+
+// Values getopt_long returns for the options with no short option
+#define STATS_OPT 256
+#define CHECKPOINT_OPT 257
+#define CHECKPOINT_EVERY_OPT 258
+#define RESTORE_OPT 259
+#define COMPACT_OPT 260
+#define COMPACT_RATE_OPT 261
+
+// Long options, each with the value getopt_long returns for it
+const struct option long_options[] = {
+    {"stats", no_argument, NULL, STATS_OPT},
+    {"checkpoint", required_argument, NULL, CHECKPOINT_OPT},
+    {"checkpoint-every", required_argument, NULL, CHECKPOINT_EVERY_OPT},
+    {"restore", required_argument, NULL, RESTORE_OPT},
+    {"compact", required_argument, NULL, COMPACT_OPT},
+    {"compact-rate", required_argument, NULL, COMPACT_RATE_OPT},
+    {NULL, 0, NULL, 0},
+};
+
+// Separates the values of an option in a parameter sweep
+#define LIST_DELIM ","
 
 // Argument buffer for getopts()
 extern char *optarg;
@@ -20,32 +49,59 @@ run_opts_t *parse_options(int argc, char **argv);
 // Prints an error message to stderr and exits the process with an error
 void parse_fail(char *process_name);
 
+// Parses a positive size from an argument, failing the parse if it isn't one
+size_t parse_size(char *arg, char *process_name);
+
 int main(int argc, char **argv) {
 
     run_opts_t *run_opts = parse_options(argc, argv);
 
-    FILE *input = fopen(run_opts->filename, "r");
-    assert(input);
+    loader_t *input = loader_open(run_opts->filename);
+    if (!input) {
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], run_opts->filename);
+        exit(EXIT_FAILURE);
+    }
+
+    if (run_opts->sweep) {
+        // Load the workload once and share it between every simulation
+        workload_t *workload = workload_load(input);
+        sweep_simulate(run_opts, workload, stdout);
 
-    char buffer[MAX_PROCESS_LINE_LENGTH + 1];
+        workload_free(workload);
+        free(run_opts->sweep);
+        free(run_opts);
+        loader_close(input);
 
-    // Create the round robin scheduler with the right configurations
-    rr_t *rr = new_rr(run_opts);
+        exit(EXIT_SUCCESS);
+    }
 
-    // Read all the processes from file and add them to the scheduler
-    // Assumes processes are in arrival time order in file
-    while (fgets(buffer, MAX_PROCESS_LINE_LENGTH, input) != NULL) {
-        process_t *process = parse_process(buffer);
-        rr_add_process(rr, process);
+    // Create the round robin scheduler with the right configurations, or
+    // carry on from where a checkpoint left off
+    rr_t *rr;
+    if (run_opts->restore_file) {
+        rr = checkpoint_restore(run_opts, run_opts->restore_file);
+        if (!rr) {
+            fprintf(stderr,
+                    "%s: cannot restore %s, it is unreadable, corrupt or "
+                    "from a run with other memory options or cores\n",
+                    argv[0], run_opts->restore_file);
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        rr = new_rr(run_opts);
     }
 
+    // Stream processes from the file as the scheduler reaches their arrival
+    // Assumes processes are in arrival time order in file
+    rr_set_reader(rr, (rr_reader_t)loader_next, input);
+
     // Simulate the round robin scheduler
     rr_simulate(rr);
     rr = NULL;
 
     // Free all used data structures
     free(run_opts);
-    fclose(input);
+    loader_close(input);
 
     exit(EXIT_SUCCESS);
 }
@@ -59,10 +115,39 @@ run_opts_t *parse_options(int argc, char **argv) {
     char *optstring = OPT_STRING;
     int c;
 
-    int f_flag = 0, m_flag = 0, q_flag = 0;
+    int f_flag = 0, m_flag = 0, q_flag = 0, s_flag = 0, j_flag = 0,
+        M_flag = 0;
+
+    // Optional arguments
+    opts->policy = ROUND_ROBIN;
+    opts->cores = 1;
+    opts->balance = STEAL;
+    opts->trace_file = NULL;
+    opts->checkpoint_file = NULL;
+    opts->checkpoint_every = DEFAULT_CHECKPOINT_EVERY;
+    opts->restore_file = NULL;
+    opts->quiet = 0;
+    opts->sweep = NULL;
+    opts->frame_size = DEFAULT_FRAME_SIZE;
+    opts->min_pages = DEFAULT_MIN_PAGES;
+    opts->replace = LRU;
+    opts->report_paging = 0;
+    opts->stats = 0;
+    opts->compact = 0;
+    opts->compact_threshold = 0;
+    opts->compact_rate = DEFAULT_COMPACT_RATE;
+
+    // Values of -m, -q and -M, which can be lists when sweeping
+    sweep_opts_t values;
+    values.n_mems = 0;
+    values.n_quanta = 0;
+    values.n_mem_sizes = 0;
+    values.threads = sysconf(_SC_NPROCESSORS_ONLN);
+    char *value;
 
     // Parse command line arguments
-    while ((c = getopt(argc, argv, optstring)) != -1) {
+    while ((c = getopt_long(argc, argv, optstring, long_options, NULL)) !=
+           -1) {
 
         switch (c) {
 
@@ -71,33 +156,130 @@ run_opts_t *parse_options(int argc, char **argv) {
             opts->filename = optarg;
             break;
 
-        case 'm': // Read the memory management type
+        case 'm': // Read the memory management types
             m_flag++;
 
-            if (strcmp(optarg, "infinite") == 0) {
-                opts->mem = INFINITE;
-            } else if (strcmp(optarg, "first-fit") == 0) {
-                opts->mem = FIRST_FIT;
-            } else if (strcmp(optarg, "paged") == 0) {
-                opts->mem = PAGED;
-            } else if (strcmp(optarg, "virtual") == 0) {
-                opts->mem = VIRTUAL;
+            for (value = strtok(optarg, LIST_DELIM); value;
+                 value = strtok(NULL, LIST_DELIM)) {
+                if (values.n_mems >= MAX_SWEEP_VALUES ||
+                    !mem_opt_parse(value, &values.mems[values.n_mems++])) {
+                    // Not a support memory option
+                    parse_fail(argv[0]);
+                }
+            }
+            break;
+
+        case 'q': // Read the quantum options
+            q_flag++;
+
+            for (value = strtok(optarg, LIST_DELIM); value;
+                 value = strtok(NULL, LIST_DELIM)) {
+                int quantum = atoi(value);
+                if (values.n_quanta >= MAX_SWEEP_VALUES || quantum < 1 ||
+                    quantum > 3) {
+                    // Not a supported quantum option
+                    parse_fail(argv[0]);
+                }
+                values.quanta[values.n_quanta++] = quantum;
+            }
+            break;
+
+        case 's': // Read the scheduling policy
+            if (!policy_opt_parse(optarg, &opts->policy)) {
+                // Not a supported policy
+                parse_fail(argv[0]);
+            }
+            break;
+
+        case 'c': // Read the number of cores
+            opts->cores = parse_size(optarg, argv[0]);
+            break;
+
+        case 'b': // Read how processes are balanced between cores
+            if (strcmp(optarg, "steal") == 0) {
+                opts->balance = STEAL;
+            } else if (strcmp(optarg, "periodic") == 0) {
+                opts->balance = PERIODIC;
             } else {
-                // Not a support memory option
                 parse_fail(argv[0]);
             }
             break;
 
-        case 'q': // Read the quantum option
-            q_flag++;
+        case 't': // Read the file to write a binary trace to
+            opts->trace_file = optarg;
+            break;
 
-            int quantum = atoi(optarg);
-            if (quantum < 1 || quantum > 3) {
-                // Not a supported memory option
+        case 'S': // Sweep over every combination of the listed values
+            s_flag++;
+            break;
+
+        case 'j': // Read the number of simulations to run at once
+            j_flag++;
+
+            values.threads = parse_size(optarg, argv[0]);
+            break;
+
+        case 'M': // Read the sizes of memory
+            M_flag++;
+
+            for (value = strtok(optarg, LIST_DELIM); value;
+                 value = strtok(NULL, LIST_DELIM)) {
+                if (values.n_mem_sizes >= MAX_SWEEP_VALUES) {
+                    parse_fail(argv[0]);
+                }
+                values.mem_sizes[values.n_mem_sizes++] =
+                    parse_size(value, argv[0]);
+            }
+            break;
+
+        case 'P': // Read the size of a frame
+            opts->frame_size = parse_size(optarg, argv[0]);
+            break;
+
+        case 'R': // Read the pages needed to run with virtual memory
+            opts->min_pages = parse_size(optarg, argv[0]);
+            break;
+
+        case 'r': // Read the page replacement policy
+            if (!replace_opt_parse(optarg, &opts->replace)) {
+                // Not a supported replacement policy
                 parse_fail(argv[0]);
             }
+            opts->report_paging = 1;
+            break;
+
+        case STATS_OPT: // Print the hot path counters after the summary
+#ifdef NO_STATS
+            // Built with STATS=0, so there are no counters to print
+            fprintf(stderr, "%s: --stats needs a build with STATS=1\n",
+                    argv[0]);
+            exit(EXIT_FAILURE);
+#endif
+            opts->stats = 1;
+            break;
+
+        case CHECKPOINT_OPT: // Read the file to keep checkpoints in
+            opts->checkpoint_file = optarg;
+            break;
+
+        case CHECKPOINT_EVERY_OPT: // Read the time between checkpoints
+            opts->checkpoint_every = parse_size(optarg, argv[0]);
+            break;
 
-            opts->quantum = quantum;
+        case RESTORE_OPT: // Read the checkpoint to carry on from
+            opts->restore_file = optarg;
+            break;
+
+        case COMPACT_OPT: // Read the fragmentation compaction starts at
+            opts->compact = 1;
+            opts->compact_threshold = atoi(optarg);
+            if (opts->compact_threshold < 0 || opts->compact_threshold > 100) {
+                parse_fail(argv[0]);
+            }
+            break;
+
+        case COMPACT_RATE_OPT: // Read how fast compaction copies memory
+            opts->compact_rate = parse_size(optarg, argv[0]);
             break;
 
         default: // Not a supported flag
@@ -106,10 +288,53 @@ run_opts_t *parse_options(int argc, char **argv) {
     }
 
     // Check for a missing flag or too many flags
-    if (f_flag != 1 || m_flag != 1 || q_flag != 1) {
+    if (f_flag != 1 || m_flag != 1 || q_flag != 1 || s_flag > 1 ||
+        j_flag > 1 || M_flag > 1) {
         parse_fail(argv[0]);
     }
 
+    if (values.n_mem_sizes == 0) {
+        values.mem_sizes[values.n_mem_sizes++] = DEFAULT_MEM_SIZE;
+    }
+
+    // Paged memory needs at least one frame, and virtual memory enough
+    // frames for a process's minimum pages
+    // Frames don't apply to the other memory types
+    for (size_t i = 0; i < values.n_mem_sizes; i++) {
+        size_t n_frames = values.mem_sizes[i] / opts->frame_size;
+        for (size_t m = 0; m < values.n_mems; m++) {
+            if ((values.mems[m] == PAGED || values.mems[m] == VIRTUAL) &&
+                n_frames < 1) {
+                parse_fail(argv[0]);
+            }
+            if (values.mems[m] == VIRTUAL && opts->min_pages > n_frames) {
+                parse_fail(argv[0]);
+            }
+        }
+    }
+
+    if (s_flag) {
+        // Sweeps only print a table of summaries
+        if (opts->trace_file || opts->stats || opts->checkpoint_file ||
+            opts->restore_file || values.n_mems < 1 || values.n_quanta < 1) {
+            parse_fail(argv[0]);
+        }
+
+        opts->sweep = malloc(sizeof(*opts->sweep));
+        assert(opts->sweep);
+        *opts->sweep = values;
+    } else {
+        // A single run takes exactly one of each value
+        if (j_flag || values.n_mems != 1 || values.n_quanta != 1 ||
+            values.n_mem_sizes != 1) {
+            parse_fail(argv[0]);
+        }
+    }
+
+    opts->mem = values.mems[0];
+    opts->quantum = values.quanta[0];
+    opts->mem_size = values.mem_sizes[0];
+
     return opts;
 }
 
@@ -117,7 +342,34 @@ run_opts_t *parse_options(int argc, char **argv) {
 void parse_fail(char *process_name) {
     fprintf(stderr,
             "Usage: %s -f <filename> -m (infinite | first-fit | paged | "
-            "virtual) -q (1 | 2 | 3)\n",
-            process_name);
+            "virtual | buddy | seg-fit) -q (1 | 2 | 3) [-s (rr | srtf | cfs)] "
+            "[-t <trace file>] [--stats] [<cores>] [<sizes>] [<paging>] "
+            "[<compaction>] [<checkpoints>]\n"
+            "       %s -S -f <filename> -m <memory>[,<memory>...] "
+            "-q <quantum>[,<quantum>...] [-M <memory KB>[,<memory KB>...]] "
+            "[-s <policy>] [-j <threads>] [<cores>] [<sizes>] [<paging>] "
+            "[<compaction>]\n"
+            "Cores: [-c <cores>] [-b (steal | periodic)]\n"
+            "Sizes: [-M <memory KB>] [-P <frame KB>] [-R <virtual memory "
+            "minimum pages>]\n"
+            "Paging: [-r (lru | clock | second-chance | working-set)]\n"
+            "Compaction: [--compact <external fragmentation %%>] "
+            "[--compact-rate <KB per unit of time>]\n"
+            "Checkpoints: [--checkpoint <file> [--checkpoint-every <time>]] "
+            "[--restore <file>]\n",
+            process_name, process_name);
     exit(EXIT_FAILURE);
 }
+
+// Parses a positive size from an argument, failing the parse if it isn't one
+size_t parse_size(char *arg, char *process_name) {
+    char *end;
+    errno = 0;
+    unsigned long long size = strtoull(arg, &end, 10);
+
+    if (errno || end == arg || *end != '\0' || size < 1 || arg[0] == '-') {
+        parse_fail(process_name);
+    }
+
+    return size;
+}
@@ -1,46 +1,130 @@
 #include "memory.h"
 #include "process.h"
+#include "stats.h"
 #include <assert.h>
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define MIN(a, b) (a < b ? a : b)
+#define CEIL_DIV(a, b) ((a + b - 1) / b)
+
+// Initial capacity of the list of evicted frames
+#define INITIAL_EVICTED 64
 
 // End of Definitions
 // ------------------------------------------------------------
 // -------------------------------------------------------------------------------
 
-// Initialises a memory strucuture of the given type
+// Command line names of the memory options, indexed by mem_opt_t
+const char *mem_opt_names[] = {"infinite", "first-fit", "paged",
+                               "virtual",  "buddy",     "seg-fit"};
+
+// Parses a memory option from its command line name
+// Returns 1 if successful, 0 if the name is not a memory option
+int mem_opt_parse(const char *name, mem_opt_t *mem) {
+    for (size_t i = 0; i < sizeof(mem_opt_names) / sizeof(*mem_opt_names);
+         i++) {
+        if (strcmp(name, mem_opt_names[i]) == 0) {
+            *mem = i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Returns the command line name of a memory option
+const char *mem_opt_name(mem_opt_t mem) {
+    return mem_opt_names[mem];
+}
+
+// Command line names of the replacement options, indexed by replace_opt_t
+const char *replace_opt_names[] = {"lru", "clock", "second-chance",
+                                   "working-set"};
+
+// Parses a page replacement option from its command line name
+// Returns 1 if successful, 0 if the name is not a replacement option
+int replace_opt_parse(const char *name, replace_opt_t *replace) {
+    for (size_t i = 0;
+         i < sizeof(replace_opt_names) / sizeof(*replace_opt_names); i++) {
+        if (strcmp(name, replace_opt_names[i]) == 0) {
+            *replace = i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Returns the command line name of a page replacement option
+const char *replace_opt_name(replace_opt_t replace) {
+    return replace_opt_names[replace];
+}
+
+// Returns the most memory a single process can be given by memory of the
+// type and sizes in the run options, SIZE_MAX if there is no such limit
+size_t mem_capacity(run_opts_t *opts) {
+    size_t order;
+
+    switch (opts->mem) {
+    case FIRST_FIT:
+    case SEG_FIT:
+        return opts->mem_size;
+    case BUDDY:
+        // The largest block is the largest power of two that fits
+        order = buddy_order(opts->mem_size);
+        if ((size_t)1 << order > opts->mem_size) {
+            order--;
+        }
+        return (size_t)1 << order;
+    case PAGED:
+        // Frames that don't fit whole are never used
+        return opts->mem_size / opts->frame_size * opts->frame_size;
+    case INFINITE:
+    case VIRTUAL:
+        // Virtual memory only needs a process's minimum pages to run
+        break;
+    }
+
+    return SIZE_MAX;
+}
+
+// Initialises a memory strucuture of the type and sizes in the run options
 // To be used by a process scheduler
-mem_t *mem_init(mem_opt_t type) {
+mem_t *mem_init(run_opts_t *opts) {
     mem_t *mem = malloc(sizeof(*mem));
     assert(mem);
 
-    mem->type = type;
+    mem->type = opts->mem;
     mem->data = NULL;
 
     switch (mem->type) {
     case INFINITE:
         break;
     case FIRST_FIT:
-        mem->data = cont_mem_init();
+        mem->data = cont_mem_init(opts->mem_size, 0);
         break;
-    case PAGED:
-        mem->data = paged_mem_init();
+    case SEG_FIT:
+        mem->data = cont_mem_init(opts->mem_size, 1);
+        break;
+    case BUDDY:
+        mem->data = buddy_mem_init(opts->mem_size);
         break;
+    case PAGED:
     case VIRTUAL:
-        mem->data = paged_mem_init();
+        mem->data =
+            paged_mem_init(opts->mem_size, opts->frame_size, opts->min_pages,
+                           opts->replace, WORKING_SET_WINDOW * opts->quantum);
         break;
     }
 
     return mem;
 }
 
-// Tries to allocate memory to given process
+// Tries to allocate memory to given process at the given time
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int mem_alloc(mem_t *mem, process_t *p) {
+size_t mem_alloc(mem_t *mem, process_t *p, size_t time) {
 
     switch (mem->type) {
     case INFINITE:
@@ -48,9 +132,13 @@ int mem_alloc(mem_t *mem, process_t *p) {
     case FIRST_FIT:
         return first_fit(mem->data, p);
     case PAGED:
-        return fit_pages(mem->data, p);
+        return fit_pages(mem->data, p, time);
     case VIRTUAL:
-        return allocate_pages(mem->data, p);
+        return allocate_pages(mem->data, p, time);
+    case BUDDY:
+        return buddy_alloc(mem->data, p);
+    case SEG_FIT:
+        return seg_fit(mem->data, p);
     }
 
     return 0;
@@ -62,16 +150,139 @@ void mem_free(mem_t *mem, process_t *p) {
     case INFINITE:
         break;
     case FIRST_FIT:
+    case SEG_FIT:
         return free_block(mem->data, p);
     case PAGED:
         return evict_all_pages(mem->data, p);
     case VIRTUAL:
         return evict_pages(mem->data, p);
+    case BUDDY:
+        return buddy_free(mem->data, p);
     }
 
     return;
 }
 
+// Evicts pages picked by the configured replacement policy at the given time
+// for process p to be allocated memory. lru is a list of the processes
+// holding memory, least recently used first
+// Running processes keep their pages, and nothing is evicted if not enough
+// memory can be freed
+// Returns 1 if p can now be allocated memory, 0 otherwise
+int mem_evict(mem_t *mem, process_t *p, list_t *lru, size_t time) {
+    if (mem->type != PAGED && mem->type != VIRTUAL) {
+        // Contiguous memory never evicts
+        return 0;
+    }
+
+    paged_mem_t *paged = (paged_mem_t *)mem->data;
+    int virtual = mem->type == VIRTUAL;
+    size_t before = paged->n_evicted;
+
+    if (paged->replace == LRU) {
+        if (!evict_lru_pages(paged, p, lru, virtual)) {
+            return 0;
+        }
+    } else {
+        size_t target = virtual ? paged->min_pages
+                                : CEIL_DIV(p->mem_size, paged->frame_size);
+        if (paged->allocatable / paged->frame_size + evictable_frames(lru) <
+            target) {
+            // The rest of memory is held by running processes
+            return 0;
+        }
+
+        switch (paged->replace) {
+        case LRU:
+            break;
+        case CLOCK:
+            clock_evict(paged, target, virtual);
+            break;
+        case SECOND_CHANCE:
+            second_chance_evict(paged, target, virtual);
+            break;
+        case WORKING_SET:
+            working_set_evict(paged, target, virtual, time);
+            break;
+        }
+    }
+
+    paged->evictions += paged->n_evicted - before;
+    return 1;
+}
+
+// Marks every page of a process as used at the given time
+void mem_touch(mem_t *mem, process_t *p, size_t time) {
+    if (mem->type != PAGED && mem->type != VIRTUAL) {
+        return;
+    }
+
+    paged_mem_t *paged = (paged_mem_t *)mem->data;
+    page_table_t *table = (page_table_t *)p->mem;
+    if (!paged->frame_state || !table) {
+        return;
+    }
+
+    for (size_t i = 0; i < table->len; i++) {
+        if (table->pages[i] != -1) {
+            frame_t *state = frame_state(paged, table->pages[i]);
+            state->referenced = 1;
+            state->last_used = time;
+            if (paged->replace == WORKING_SET) {
+                frame_to_back(paged, table->pages[i]);
+            }
+        }
+    }
+}
+
+// Returns the number of pages allocated to processes, 0 if memory is not
+// paged
+size_t mem_page_faults(mem_t *mem) {
+    if (mem->type != PAGED && mem->type != VIRTUAL) {
+        return 0;
+    }
+
+    return ((paged_mem_t *)mem->data)->faults;
+}
+
+// Returns the number of frames evicted to make room for other processes
+size_t mem_evictions(mem_t *mem) {
+    if (mem->type != PAGED && mem->type != VIRTUAL) {
+        return 0;
+    }
+
+    return ((paged_mem_t *)mem->data)->evictions;
+}
+
+// Slides every allocated block of contiguous memory down to the lowest
+// addresses, merging the free memory into one block at the end
+// Returns the amount of allocated memory moved, 0 for other memory types
+size_t mem_compact(mem_t *mem) {
+    if (mem->type != FIRST_FIT && mem->type != SEG_FIT) {
+        return 0;
+    }
+
+    return compact_blocks(mem->data);
+}
+
+// Returns the number of times contiguous memory has been compacted
+size_t mem_compactions(mem_t *mem) {
+    if (mem->type != FIRST_FIT && mem->type != SEG_FIT) {
+        return 0;
+    }
+
+    return ((cont_mem_t *)mem->data)->compactions;
+}
+
+// Returns the total amount of memory moved by compacting contiguous memory
+size_t mem_compacted(mem_t *mem) {
+    if (mem->type != FIRST_FIT && mem->type != SEG_FIT) {
+        return 0;
+    }
+
+    return ((cont_mem_t *)mem->data)->compacted;
+}
+
 // Checks whether a process has enough memory to run
 // Returns 1 if the process can run, 0 otherwise
 int mem_check(mem_t *mem, process_t *p) {
@@ -79,6 +290,8 @@ int mem_check(mem_t *mem, process_t *p) {
     case INFINITE:
         return 1;
     case FIRST_FIT:
+    case BUDDY:
+    case SEG_FIT:
         return p->mem != NULL;
     case PAGED:
         return p->mem != NULL;
@@ -87,7 +300,7 @@ int mem_check(mem_t *mem, process_t *p) {
             return 0;
         page_table_t *table = (page_table_t *)p->mem;
         return (table->allocated >= table->n_pages ||
-                table->allocated >= MIN_PAGES);
+                table->allocated >= ((paged_mem_t *)mem->data)->min_pages);
     }
 
     return 0;
@@ -99,14 +312,37 @@ void mem_struct_free(mem_t *mem) {
     case INFINITE:
         break;
     case FIRST_FIT:
-        list_free(mem->data, free);
+        list_free(((cont_mem_t *)mem->data)->blocks, NULL);
+        block_tree_free(((cont_mem_t *)mem->data)->free);
+        pool_free(((cont_mem_t *)mem->data)->block_pool);
+        pool_free(((cont_mem_t *)mem->data)->node_pool);
+        free(mem->data);
+        break;
+    case SEG_FIT:
+        for (size_t i = 0; i < SIZE_CLASSES; i++) {
+            list_free(((cont_mem_t *)mem->data)->classes[i], NULL);
+        }
+        free(((cont_mem_t *)mem->data)->classes);
+        list_free(((cont_mem_t *)mem->data)->blocks, NULL);
+        pool_free(((cont_mem_t *)mem->data)->block_pool);
+        pool_free(((cont_mem_t *)mem->data)->node_pool);
+        free(mem->data);
+        break;
+    case BUDDY:
+        buddy_mem_free(mem->data);
         break;
     case PAGED:
-        free(((paged_mem_t *)mem->data)->frames);
+        bitmap_free(((paged_mem_t *)mem->data)->frames);
+        pool_free(((paged_mem_t *)mem->data)->table_pool);
+        free(((paged_mem_t *)mem->data)->evicted);
+        paged_mem_free_state(mem->data);
         free(mem->data);
         break;
     case VIRTUAL:
-        free(((paged_mem_t *)mem->data)->frames);
+        bitmap_free(((paged_mem_t *)mem->data)->frames);
+        pool_free(((paged_mem_t *)mem->data)->table_pool);
+        free(((paged_mem_t *)mem->data)->evicted);
+        paged_mem_free_state(mem->data);
         free(mem->data);
         break;
     }
@@ -121,114 +357,290 @@ int mem_usage(mem_t *mem) {
     case INFINITE:
         return 0;
     case FIRST_FIT:
-        node_t *curr = ((cont_mem_t *)mem->data)->head;
-        double used = 0;
-        double total = 0;
-
-        while (curr) {
-            mem_block_t *block = (mem_block_t *)curr->data;
-            if (block->allocated) {
-                used += block->size;
-            }
-            total += block->size;
+    case BUDDY:
+    case SEG_FIT:
+        return ceil(mem_used(mem) / (double)mem_total(mem) * 100);
+    case PAGED:
+        return ceil(100 - ((paged_mem_t *)mem->data)->allocatable /
+                              (double)mem_total(mem) * 100.0);
+    case VIRTUAL:
+        return ceil(mem_used(mem) / (double)mem_total(mem) * 100.0);
+    }
 
-            curr = curr->next;
-        }
+    return 0;
+}
 
-        return ceil(used / total * 100);
+// Returns the amount of memory currently allocated to processes
+size_t mem_used(mem_t *mem) {
+    switch (mem->type) {
+    case INFINITE:
+        return 0;
+    case FIRST_FIT:
+    case SEG_FIT:
+        return ((cont_mem_t *)mem->data)->used;
     case PAGED:
-        return ceil(100 - ((paged_mem_t *)mem->data)->allocatable /
-                              (double)MAX_MEM * 100.0);
     case VIRTUAL:
-        return ceil(((paged_mem_t *)mem->data)->used / (double)MAX_MEM * 100.0);
+        return ((paged_mem_t *)mem->data)->used;
+    case BUDDY:
+        return ((buddy_mem_t *)mem->data)->used;
+    }
+
+    return 0;
+}
+
+// Returns the total amount of memory managed by the mem struct
+size_t mem_total(mem_t *mem) {
+    switch (mem->type) {
+    case INFINITE:
+        return 0;
+    case FIRST_FIT:
+    case SEG_FIT:
+        return ((cont_mem_t *)mem->data)->total;
+    case PAGED:
+    case VIRTUAL:
+        return ((paged_mem_t *)mem->data)->n_frames *
+               ((paged_mem_t *)mem->data)->frame_size;
+    case BUDDY:
+        return ((buddy_mem_t *)mem->data)->total;
+    }
+
+    return 0;
+}
+
+// Returns the address a process's contiguous memory starts at
+size_t mem_allocated_at(mem_t *mem, process_t *p) {
+    switch (mem->type) {
+    case FIRST_FIT:
+    case SEG_FIT:
+        return ((mem_block_t *)((node_t *)p->mem)->data)->start;
+    case BUDDY:
+        return ((mem_block_t *)p->mem)->start;
+    case INFINITE:
+    case PAGED:
+    case VIRTUAL:
+        break;
     }
 
     return 0;
 }
 
+// Returns the percentage of allocated memory processes didn't ask for
+int mem_internal_frag(mem_t *mem) {
+    if (mem->type != BUDDY) {
+        // Every other memory type allocates processes exactly what they ask
+        // for, to the frame for paged memory
+        return 0;
+    }
+
+    buddy_mem_t *buddy = (buddy_mem_t *)mem->data;
+    if (!buddy->used) {
+        return 0;
+    }
+    return ceil((buddy->used - buddy->requested) / (double)buddy->used * 100);
+}
+
+// Returns the percentage of free memory outside the largest free block
+int mem_external_frag(mem_t *mem) {
+    if (mem->type != FIRST_FIT && mem->type != SEG_FIT &&
+        mem->type != BUDDY) {
+        // Any free frame is as good as another
+        return 0;
+    }
+
+    size_t largest = mem_largest_free(mem);
+    size_t free_mem = mem_total(mem) - mem_used(mem);
+    if (!free_mem) {
+        return 0;
+    }
+    return ceil((free_mem - largest) / (double)free_mem * 100);
+}
+
+// Returns the size of the largest free block of contiguous or buddy memory,
+// 0 for other memory types
+size_t mem_largest_free(mem_t *mem) {
+    size_t largest = 0;
+
+    switch (mem->type) {
+    case FIRST_FIT:
+    case SEG_FIT:
+        largest = largest_free_block(mem->data);
+        break;
+    case BUDDY:
+        for (size_t i = 0; i <= ((buddy_mem_t *)mem->data)->max_order; i++) {
+            if (((buddy_mem_t *)mem->data)->free[i]->len > 0) {
+                largest = (size_t)1 << i;
+            }
+        }
+        break;
+    case INFINITE:
+    case PAGED:
+    case VIRTUAL:
+        break;
+    }
+
+    return largest;
+}
+
+// Returns the frames evicted since the evicted frames were last cleared, in
+// eviction order, storing how many there are in len
+long *mem_evicted(mem_t *mem, size_t *len) {
+    switch (mem->type) {
+    case INFINITE:
+    case FIRST_FIT:
+    case BUDDY:
+    case SEG_FIT:
+        *len = 0;
+        return NULL;
+    case PAGED:
+    case VIRTUAL:
+        *len = ((paged_mem_t *)mem->data)->n_evicted;
+        return ((paged_mem_t *)mem->data)->evicted;
+    }
+
+    *len = 0;
+    return NULL;
+}
+
+// Clears the list of evicted frames
+void mem_clear_evicted(mem_t *mem) {
+    if (mem->type == PAGED || mem->type == VIRTUAL) {
+        ((paged_mem_t *)mem->data)->n_evicted = 0;
+    }
+}
+
 // Contiguous memory method implementations
 // --------------------------------------
 // -------------------------------------------------------------------------------
 
-// Initialises unallocated contiguous memory of size MAX_MEM
-cont_mem_t *cont_mem_init() {
-    cont_mem_t *mem = (cont_mem_t *)new_list();
-    mem_block_t *block = malloc(sizeof(*block));
-    assert(block);
+// Initialises unallocated contiguous memory of the provided size, indexing
+// free blocks by size class if segregated is set
+cont_mem_t *cont_mem_init(size_t size, int segregated) {
+    cont_mem_t *mem = malloc(sizeof(*mem));
+    assert(mem);
+    mem->block_pool = new_pool(sizeof(mem_block_t));
+    mem->node_pool = new_pool(sizeof(node_t));
+    mem->blocks = new_pooled_list(mem->node_pool);
+    mem->free = NULL;
+    mem->classes = NULL;
+    if (segregated) {
+        mem->classes = malloc(sizeof(*mem->classes) * SIZE_CLASSES);
+        assert(mem->classes);
+        for (size_t i = 0; i < SIZE_CLASSES; i++) {
+            mem->classes[i] = new_pooled_list(mem->node_pool);
+        }
+    } else {
+        mem->free = new_block_tree();
+    }
+    mem->used = 0;
+    mem->total = size;
+    mem->compactions = 0;
+    mem->compacted = 0;
+
+    mem_block_t *block = pool_alloc(mem->block_pool);
 
     block->allocated = 0;
     block->start = 0;
-    block->end = MAX_MEM - 1;
-    block->size = MAX_MEM;
+    block->end = size - 1;
+    block->size = size;
+    block->class_node = NULL;
 
-    list_add_tail((list_t *)mem, block);
+    node_t *node = list_add_tail(mem->blocks, block);
+    free_index_add(mem, node);
 
     return mem;
 }
 
 // Tries to allocate memory to given process using a first-fit policy
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int first_fit(cont_mem_t *mem, process_t *p) {
-    node_t *curr = mem->head;
-
-    // Traverse all contiguous memory until a big enough block is found
-    while (curr) {
+size_t first_fit(cont_mem_t *mem, process_t *p) {
+    // Find the lowest addressed free block that is big enough
+    node_t *curr = block_tree_first_fit(mem->free, p->mem_size);
+    if (!curr) {
+        return 0;
+    }
 
-        mem_block_t *block = (mem_block_t *)curr->data;
+    return allocate_block(mem, curr, p);
+}
 
-        if (!block->allocated && block->size >= p->mem_size) {
-            // First big enough block found, allocate memory
-            if (p->mem_size == block->size) {
-                // Allocate the whole block
-                block->allocated = 1;
-                p->mem = curr;
-                return block->size;
-            }
+// Tries to allocate memory to given process from the smallest size class
+// with a big enough block
+// Returns 0 if unsuccessful, the amount of memory allocated otherwise
+size_t seg_fit(cont_mem_t *mem, process_t *p) {
+    size_t class = size_class(p->mem_size);
+
+    // Only some blocks of the process's own class are big enough
+    for (node_t *curr = mem->classes[class]->head; curr; curr = curr->next) {
+        STAT_INC(blocks_scanned);
+        node_t *node = (node_t *)curr->data;
+        if (((mem_block_t *)node->data)->size >= p->mem_size) {
+            return allocate_block(mem, node, p);
+        }
+    }
 
-            // Only part of the block needs to be allocated, fragment block
+    // But any block of a bigger class is
+    for (class++; class < SIZE_CLASSES; class++) {
+        STAT_INC(blocks_scanned);
+        if (mem->classes[class]->len > 0) {
+            return allocate_block(mem, mem->classes[class]->head->data, p);
+        }
+    }
 
-            // Create the new node in the linked list and place it before
-            // current node
-            node_t *new = malloc(sizeof(*new));
-            assert(new);
-            mem->len += 1;
+    return 0;
+}
 
-            if (!curr->prev) {
-                // Curr is head
-                mem->head = new;
-                new->next = curr;
-                curr->prev = new;
-                new->prev = NULL;
-            } else {
-                new->prev = curr->prev;
-                new->next = curr;
-                curr->prev = new;
-                new->prev->next = new;
-            }
+// Allocates the start of a free block to a given process, leaving the rest
+// of the block free
+// Returns the amount of memory allocated
+size_t allocate_block(cont_mem_t *mem, node_t *curr, process_t *p) {
+    mem_block_t *block = (mem_block_t *)curr->data;
+    free_index_remove(mem, curr);
+    mem->used += p->mem_size;
 
-            // Initialise the data of the new allocated block
-            mem_block_t *new_block = malloc(sizeof(*new_block));
-            assert(new_block);
+    if (p->mem_size == block->size) {
+        // Allocate the whole block
+        block->allocated = 1;
+        p->mem = curr;
+        return block->size;
+    }
 
-            new_block->allocated = 1;
-            new_block->start = block->start;
-            new_block->end = block->start + p->mem_size - 1;
-            new_block->size = p->mem_size;
+    // Only part of the block needs to be allocated, fragment block
+
+    // Create the new node in the linked list and place it before
+    // current node
+    node_t *new = list_node_alloc(mem->blocks);
+    mem->blocks->len += 1;
+
+    if (!curr->prev) {
+        // Curr is head
+        mem->blocks->head = new;
+        new->next = curr;
+        curr->prev = new;
+        new->prev = NULL;
+    } else {
+        new->prev = curr->prev;
+        new->next = curr;
+        curr->prev = new;
+        new->prev->next = new;
+    }
 
-            new->data = new_block;
-            p->mem = new;
+    // Initialise the data of the new allocated block
+    mem_block_t *new_block = pool_alloc(mem->block_pool);
 
-            // Update the free block, making it smaller
-            block->start = new_block->start + p->mem_size;
-            block->size = block->end - block->start + 1;
+    new_block->allocated = 1;
+    new_block->start = block->start;
+    new_block->end = block->start + p->mem_size - 1;
+    new_block->size = p->mem_size;
+    new_block->class_node = NULL;
 
-            return p->mem_size;
-        }
+    new->data = new_block;
+    p->mem = new;
 
-        curr = curr->next;
-    }
+    // Update the free block, making it smaller
+    block->start = new_block->start + p->mem_size;
+    block->size = block->end - block->start + 1;
+    free_index_add(mem, curr);
 
-    return 0;
+    return p->mem_size;
 }
 
 // Frees a block memory used by a provided process
@@ -242,188 +654,553 @@ void free_block(cont_mem_t *mem, process_t *process) {
     }
 
     mem_block_t *b = (mem_block_t *)block->data;
-    mem_block_t *p;
-    mem_block_t *n;
+    b->allocated = 0;
+    mem->used -= b->size;
 
     node_t *prev = block->prev;
     node_t *next = block->next;
 
-    // Both prev and next are null, the block is the entire memory
-    if (!prev && !next) {
-        // Simply freeing it is sufficient
-        b->allocated = 0;
-        return;
+    // Coalesce with the next block if it is free
+    if (next && !((mem_block_t *)next->data)->allocated) {
+        free_index_remove(mem, next);
+        merge_blocks(mem, block);
+    }
+
+    // Coalesce with the previous block if it is free
+    if (prev && !((mem_block_t *)prev->data)->allocated) {
+        free_index_remove(mem, prev);
+        merge_blocks(mem, prev);
+        block = prev;
     }
 
-    // Only prev is null
-    if (!prev) {
-        n = (mem_block_t *)next->data;
-        // Two cases, no action needed besides freeing if next is allocated
-        if (n->allocated) {
-            b->allocated = 0;
+    free_index_add(mem, block);
+}
+
+// Merges the block after the provided node into it, freeing the later block
+void merge_blocks(cont_mem_t *mem, node_t *node) {
+    node_t *next = node->next;
+    mem_block_t *b = (mem_block_t *)node->data;
+    mem_block_t *n = (mem_block_t *)next->data;
+
+    mem->blocks->len -= 1;
+    node->next = next->next;
+    if (node->next) {
+        node->next->prev = node;
+    } else {
+        mem->blocks->tail = node;
+    }
+
+    b->end = n->end;
+    b->size = b->end - b->start + 1;
+    pool_release(mem->block_pool, n);
+    list_node_free(mem->blocks, next);
+}
+
+// Slides every allocated block down to the lowest addresses, keeping their
+// order, and merges the free memory into one block at the end
+// Processes keep their blocks, only the blocks' addresses change
+// Returns the total size of the allocated blocks that moved
+size_t compact_blocks(cont_mem_t *mem) {
+    size_t start = 0, moved = 0;
+
+    node_t *node = mem->blocks->head;
+    while (node) {
+        node_t *next = node->next;
+        mem_block_t *block = (mem_block_t *)node->data;
+
+        if (!block->allocated) {
+            // Free blocks are gathered into one at the end
+            free_index_remove(mem, node);
+            list_remove(mem->blocks, node);
+            pool_release(mem->block_pool, block);
         } else {
-            // Merge the mem blocks
-            mem->len -= 1;
-            b->allocated = 0;
-            block->next = next->next;
-            if (block->next) {
-                block->next->prev = block;
+            if (block->start != start) {
+                moved += block->size;
+                block->start = start;
+                block->end = start + block->size - 1;
             }
-            b->end = n->end;
-            b->size = b->end - b->start + 1;
-            free(n);
-            free(next);
+            start += block->size;
         }
 
-        return;
+        node = next;
     }
 
-    // Only next is null;
-    if (!next) {
-        p = (mem_block_t *)prev->data;
+    if (start < mem->total) {
+        mem_block_t *block = pool_alloc(mem->block_pool);
+        block->allocated = 0;
+        block->start = start;
+        block->end = mem->total - 1;
+        block->size = mem->total - start;
+        block->class_node = NULL;
+        free_index_add(mem, list_add_tail(mem->blocks, block));
+    }
 
-        // Two cases, no action needed besides freeing if prev is allocated
-        if (p->allocated) {
-            b->allocated = 0;
-        } else {
-            // Merge the mem blocks
-            mem->len -= 1;
-            prev->next = NULL;
-            mem->tail = prev;
-            p->end = b->end;
-            p->size = p->end - p->start + 1;
-            free(b);
-            free(block);
-        }
+    mem->compactions += 1;
+    mem->compacted += moved;
+    return moved;
+}
 
-        return;
+// Indexes a free block, given by its list node, for allocation
+void free_index_add(cont_mem_t *mem, node_t *node) {
+    mem_block_t *block = (mem_block_t *)node->data;
+
+    if (mem->classes) {
+        block->class_node =
+            list_add_tail(mem->classes[size_class(block->size)], node);
+    } else {
+        block_tree_insert(mem->free, block->start, block->size, node);
     }
+}
 
-    n = (mem_block_t *)next->data;
-    p = (mem_block_t *)prev->data;
+// Removes a free block, given by its list node, from the allocation index
+void free_index_remove(cont_mem_t *mem, node_t *node) {
+    mem_block_t *block = (mem_block_t *)node->data;
 
-    // Neither prev or next are null
-    // There are 4 cases
-    if (p->allocated && n->allocated) {
-        b->allocated = 0;
-        return;
+    if (mem->classes) {
+        list_remove(mem->classes[size_class(block->size)], block->class_node);
+        block->class_node = NULL;
+    } else {
+        block_tree_remove(mem->free, block->start);
+    }
+}
+
+// Returns the size class of a block size
+size_t size_class(size_t size) {
+    size_t class = 0;
+    while (size >>= 1) {
+        class++;
+    }
+
+    return class;
+}
+
+// Returns the size of the largest free block
+size_t largest_free_block(cont_mem_t *mem) {
+    if (!mem->classes) {
+        return block_tree_max(mem->free);
     }
 
-    if (p->allocated && !n->allocated) {
-        // Merge block with next
-        mem->len -= 1;
-        b->allocated = 0;
-        block->next = next->next;
-        if (block->next) {
-            block->next->prev = block;
+    // The largest block is in the biggest class with any blocks
+    size_t largest = 0;
+    for (size_t class = SIZE_CLASSES; class-- > 0 && !largest;) {
+        for (node_t *curr = mem->classes[class]->head; curr;
+             curr = curr->next) {
+            mem_block_t *block = (mem_block_t *)((node_t *)curr->data)->data;
+            largest = block->size > largest ? block->size : largest;
         }
-        b->end = n->end;
-        b->size = b->end - b->start + 1;
-        free(n);
-        free(next);
-        return;
     }
 
-    if (!p->allocated && n->allocated) {
-        // Merge block with prev
-        mem->len -= 1;
-        prev->next = block->next;
-        if (prev->next) {
-            prev->next->prev = prev;
+    return largest;
+}
+
+// Buddy memory method implementations
+// -------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Initialises unallocated buddy memory of the provided size
+buddy_mem_t *buddy_mem_init(size_t size) {
+    buddy_mem_t *mem = malloc(sizeof(*mem));
+    assert(mem);
+
+    mem->max_order = buddy_order(size);
+    if ((size_t)1 << mem->max_order > size) {
+        mem->max_order--;
+    }
+    mem->used = 0;
+    mem->requested = 0;
+    mem->total = size;
+    mem->block_pool = new_pool(sizeof(mem_block_t));
+
+    mem->free = malloc(sizeof(*mem->free) * (mem->max_order + 1));
+    assert(mem->free);
+    for (size_t i = 0; i <= mem->max_order; i++) {
+        mem->free[i] = new_block_tree();
+    }
+
+    // Lay out the largest blocks first, so every block starts at a multiple
+    // of its size like its buddies will
+    size_t start = 0;
+    for (size_t order = mem->max_order + 1; order-- > 0;) {
+        if (!(size & (size_t)1 << order)) {
+            continue;
         }
-        p->end = b->end;
-        p->size = p->end - p->start + 1;
-        free(b);
-        free(block);
+
+        mem_block_t *block = pool_alloc(mem->block_pool);
+        block->allocated = 0;
+        block->start = start;
+        block->size = (size_t)1 << order;
+        block->end = start + block->size - 1;
+        block->class_node = NULL;
+        block_tree_insert(mem->free[order], block->start, block->size, block);
+        start += block->size;
+    }
+
+    return mem;
+}
+
+// Tries to allocate the smallest block of a power of two size to a process
+// Returns 0 if unsuccessful, the amount of memory allocated otherwise
+size_t buddy_alloc(buddy_mem_t *mem, process_t *p) {
+    size_t order = buddy_order(p->mem_size);
+
+    // Find the smallest free block that is big enough
+    size_t split = order;
+    while (split <= mem->max_order && mem->free[split]->len < 1) {
+        STAT_INC(blocks_scanned);
+        split++;
+    }
+    if (split > mem->max_order) {
+        return 0;
+    }
+
+    // Take the lowest addressed one, freeing the upper half of it until it's
+    // as small as possible
+    mem_block_t *block = block_tree_first_fit(mem->free[split], 1);
+    block_tree_remove(mem->free[split], block->start);
+    while (split > order) {
+        split--;
+
+        mem_block_t *upper = pool_alloc(mem->block_pool);
+        upper->allocated = 0;
+        upper->start = block->start + ((size_t)1 << split);
+        upper->size = (size_t)1 << split;
+        upper->end = upper->start + upper->size - 1;
+        upper->class_node = NULL;
+        block_tree_insert(mem->free[split], upper->start, upper->size, upper);
+    }
+
+    block->allocated = 1;
+    block->size = (size_t)1 << order;
+    block->end = block->start + block->size - 1;
+    mem->used += block->size;
+    mem->requested += p->mem_size;
+    p->mem = block;
+
+    return block->size;
+}
+
+// Frees the block used by a provided process, merging it with its buddies
+void buddy_free(buddy_mem_t *mem, process_t *p) {
+    mem_block_t *block = (mem_block_t *)p->mem;
+    p->mem = NULL;
+
+    // No allocated memory to process, return
+    if (!block) {
         return;
     }
 
-    if (!p->allocated && !n->allocated) {
-        // Merge all three
-        mem->len -= 2;
-        prev->next = next->next;
-        if (prev->next) {
-            prev->next->prev = prev;
-        }
-        if (mem->tail == next) {
-            mem->tail = prev;
+    mem->used -= block->size;
+    mem->requested -= p->mem_size;
+
+    // A block's buddy differs from it only in the bit of its size
+    size_t order = buddy_order(block->size);
+    while (order < mem->max_order) {
+        size_t buddy_start = block->start ^ ((size_t)1 << order);
+        mem_block_t *buddy = block_tree_find(mem->free[order], buddy_start);
+        if (!buddy) {
+            break;
         }
-        p->end = n->end;
-        p->size = p->end - p->start + 1;
-        free(b);
-        free(block);
-        free(n);
-        free(next);
-        return;
+
+        block_tree_remove(mem->free[order], buddy_start);
+        block->start = MIN(block->start, buddy_start);
+        pool_release(mem->block_pool, buddy);
+        order++;
     }
 
-    return;
+    block->allocated = 0;
+    block->size = (size_t)1 << order;
+    block->end = block->start + block->size - 1;
+    block_tree_insert(mem->free[order], block->start, block->size, block);
+}
+
+// Frees buddy memory and its blocks
+void buddy_mem_free(buddy_mem_t *mem) {
+    for (size_t i = 0; i <= mem->max_order; i++) {
+        block_tree_free(mem->free[i]);
+    }
+    free(mem->free);
+    pool_free(mem->block_pool);
+    free(mem);
+}
+
+// Returns the order of the smallest block that holds the given size
+size_t buddy_order(size_t size) {
+    size_t order = 0;
+    while (((size_t)1 << order) < size) {
+        order++;
+    }
+
+    return order;
 }
 
 // Paged memory method implementations
 // -------------------------------------------
 // -------------------------------------------------------------------------------
 
-// Initialises unallocated paged memory of size MAX_MEM and frame size
-// FRAME_SIZE
-paged_mem_t *paged_mem_init() {
+// Initialises unallocated paged memory of the provided size, split into
+// frames of frame_size, evicting pages with the given replacement policy
+// window is only used by WORKING_SET replacement
+paged_mem_t *paged_mem_init(size_t size, size_t frame_size, size_t min_pages,
+                            replace_opt_t replace, size_t window) {
     paged_mem_t *mem = malloc(sizeof(*mem));
     assert(mem);
 
-    mem->allocatable = MAX_MEM;
+    mem->frame_size = frame_size;
+    mem->min_pages = min_pages;
+    mem->n_frames = size / frame_size;
+    mem->allocatable = mem->n_frames * frame_size;
     mem->used = 0;
-    mem->n_frames = MAX_MEM / FRAME_SIZE;
-    mem->frames = calloc(mem->n_frames, sizeof(int));
+    mem->frames = new_bitmap(mem->n_frames);
+    mem->table_pool = new_pool(sizeof(page_table_t));
+
+    // Grown as needed, so huge memories don't pay for a list of every frame
+    mem->n_evicted = 0;
+    mem->evicted_cap = INITIAL_EVICTED;
+    mem->evicted = malloc(sizeof(*mem->evicted) * mem->evicted_cap);
+    assert(mem->evicted);
+
+    // LRU evicts whole processes, so only the other policies track frames
+    mem->replace = replace;
+    // Their state is only allocated for the chunks of frames that get used,
+    // so huge memories don't pay for the state of every frame either
+    mem->frame_state = NULL;
+    mem->n_chunks = CEIL_DIV(mem->n_frames, FRAME_CHUNK);
+    if (replace != LRU) {
+        mem->frame_state = calloc(mem->n_chunks, sizeof(*mem->frame_state));
+        assert(mem->frame_state);
+    }
+    mem->hand = 0;
+    mem->oldest = -1;
+    mem->window = window;
+    mem->faults = 0;
+    mem->evictions = 0;
 
     return mem;
 }
 
-// Initialises a page table that covers a provided size of memory
-page_table_t *page_table_init(size_t mem_size) {
-    page_table_t *table = malloc(sizeof(*table));
-    assert(table);
+// Initialises a page table that covers the memory of a provided process
+page_table_t *page_table_init(paged_mem_t *mem, process_t *p) {
+    page_table_t *table = pool_alloc(mem->table_pool);
 
-    table->n_pages = ceil(mem_size / (double)FRAME_SIZE);
-    table->pages = malloc(sizeof(*table->pages) * table->n_pages);
-    assert(table->pages);
+    table->process = p;
+    table->n_pages = CEIL_DIV(p->mem_size, mem->frame_size);
+    table->pages = NULL;
+    table->len = 0;
+    table->cap = 0;
     table->allocated = 0;
+    table->hole = 0;
 
-    for (int i = 0; i < table->n_pages; i++) {
-        table->pages[i] = -1;
+    return table;
+}
+
+// Frees a page table, without freeing the frames it holds
+void page_table_free(paged_mem_t *mem, page_table_t *table) {
+    free(table->pages);
+    pool_release(mem->table_pool, table);
+}
+
+// Allocates up to n of a page table's unallocated pages, lowest pages first
+// Returns the number of pages allocated
+size_t page_table_fill(paged_mem_t *mem, page_table_t *table, size_t n,
+                       size_t time) {
+    size_t filled = 0;
+    size_t page = table->hole;
+
+    // Fill the holes left by evicted pages, a run of them at a time
+    while (filled < n && page < table->len) {
+        STAT_INC(frame_scan_steps);
+        if (table->pages[page] != -1) {
+            page++;
+            continue;
+        }
+
+        size_t run = 1;
+        while (page + run < table->len && table->pages[page + run] == -1) {
+            run++;
+        }
+
+        size_t taken = bitmap_take_zeros(mem->frames, MIN(run, n - filled),
+                                         &table->pages[page]);
+        for (size_t i = 0; mem->frame_state && i < taken; i++) {
+            load_frame(mem, table, page + i, time);
+        }
+        filled += taken;
+        page += taken;
+        if (taken < run) {
+            // Out of frames
+            break;
+        }
     }
 
-    return table;
+    // Then extend the table with pages that have never been allocated
+    if (filled < n && page >= table->len && table->len < table->n_pages) {
+        size_t extend = MIN(n - filled, table->n_pages - table->len);
+        page_table_reserve(table, table->len + extend);
+        size_t taken = bitmap_take_zeros(mem->frames, extend,
+                                         &table->pages[table->len]);
+        for (size_t i = 0; mem->frame_state && i < taken; i++) {
+            load_frame(mem, table, table->len + i, time);
+        }
+        table->len += taken;
+        filled += taken;
+        page = table->len;
+    }
+
+    table->hole = page;
+    table->allocated += filled;
+    mem->faults += filled;
+    mem->allocatable -= filled * mem->frame_size;
+    mem->used += filled * mem->frame_size;
+
+    return filled;
+}
+
+// Grows a page table to hold at least len entries
+void page_table_reserve(page_table_t *table, size_t len) {
+    if (len <= table->cap) {
+        return;
+    }
+
+    // Grow geometrically so a process made resident a few pages at a time
+    // is only copied a logarithmic number of times
+    size_t cap = table->cap * 2 > len ? table->cap * 2 : len;
+    size_t max = table->n_pages > len ? table->n_pages : len;
+    cap = MIN(cap, max);
+
+    table->pages = realloc(table->pages, sizeof(*table->pages) * cap);
+    assert(table->pages);
+    STAT_INC(mallocs);
+    for (size_t i = table->cap; i < cap; i++) {
+        table->pages[i] = -1;
+    }
+    table->cap = cap;
 }
 
 // Tries to allocate memorty to a given process using paged memory
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int fit_pages(paged_mem_t *mem, process_t *p) {
+size_t fit_pages(paged_mem_t *mem, process_t *p, size_t time) {
     if (p->mem_size > mem->allocatable) {
         // Cannot allocate any memory
         return 0;
     }
 
-    page_table_t *table = page_table_init(p->mem_size);
+    page_table_t *table = page_table_init(mem, p);
 
-    int frame = 0;
-    for (int i = 0; i < table->n_pages; i++) {
-        // Should never go past max index since memory is allocatable
-        // Find the next unallocated frame
-        while (mem->frames[frame]) {
-            frame++;
-        }
+    // Should always allocate every page since memory is allocatable
+    page_table_fill(mem, table, table->n_pages, time);
+    p->mem = table;
 
-        // Allocate frame
-        table->pages[i] = frame;
-        mem->frames[frame] = 1;
-        mem->allocatable -= FRAME_SIZE;
-        table->allocated += 1;
+    return table->n_pages;
+}
+
+// Returns the replacement state of a frame, NULL if no frame of its chunk has
+// been loaded yet
+frame_t *frame_state(paged_mem_t *mem, long frame) {
+    frame_t *chunk = mem->frame_state[frame / FRAME_CHUNK];
+    return chunk ? &chunk[frame % FRAME_CHUNK] : NULL;
+}
+
+// Returns the replacement state of a frame, allocating the state of its chunk
+// if no frame of it has been loaded yet
+frame_t *frame_state_alloc(paged_mem_t *mem, long frame) {
+    frame_t **chunk = &mem->frame_state[frame / FRAME_CHUNK];
+    if (!*chunk) {
+        // Every frame of a new chunk is free
+        *chunk = calloc(FRAME_CHUNK, sizeof(**chunk));
+        assert(*chunk);
+        STAT_INC(mallocs);
     }
 
-    mem->used += p->mem_size;
-    p->mem = table;
+    return &(*chunk)[frame % FRAME_CHUNK];
+}
+
+// Frees the replacement state of the frames
+void paged_mem_free_state(paged_mem_t *mem) {
+    for (size_t i = 0; mem->frame_state && i < mem->n_chunks; i++) {
+        free(mem->frame_state[i]);
+    }
+    free(mem->frame_state);
+}
+
+// Records a page newly loaded into its frame at the given time for replacement
+void load_frame(paged_mem_t *mem, page_table_t *table, size_t page,
+                size_t time) {
+    long frame = table->pages[page];
+    frame_t *state = frame_state_alloc(mem, frame);
+
+    state->table = table;
+    state->page = page;
+    state->referenced = 1;
+    state->last_used = time;
+
+    // Frames are kept in a circular list in the order they were loaded
+    if (mem->oldest == -1) {
+        state->prev = state->next = frame;
+        mem->oldest = frame;
+    } else {
+        frame_t *oldest = frame_state(mem, mem->oldest);
+        state->next = mem->oldest;
+        state->prev = oldest->prev;
+        frame_state(mem, oldest->prev)->next = frame;
+        oldest->prev = frame;
+    }
+}
+
+// Moves a loaded frame to the back of the order, as the most recently used
+void frame_to_back(paged_mem_t *mem, long frame) {
+    if (frame == mem->oldest) {
+        // The order is circular, so the oldest frame is just before the next
+        mem->oldest = frame_state(mem, frame)->next;
+        return;
+    }
+
+    frame_t *state = frame_state(mem, frame);
+    if (state->next == mem->oldest) {
+        // Already at the back
+        return;
+    }
+
+    frame_state(mem, state->prev)->next = state->next;
+    frame_state(mem, state->next)->prev = state->prev;
+
+    frame_t *oldest = frame_state(mem, mem->oldest);
+    state->next = mem->oldest;
+    state->prev = oldest->prev;
+    frame_state(mem, oldest->prev)->next = frame;
+    oldest->prev = frame;
+}
+
+// Frees a frame, recording it in the list of evicted frames
+void evict_frame(paged_mem_t *mem, long frame) {
+    bitmap_clear(mem->frames, frame);
+
+    if (mem->frame_state) {
+        frame_t *state = frame_state(mem, frame);
+        state->table = NULL;
+
+        // Remove the frame from the load order
+        if (state->next == frame) {
+            mem->oldest = -1;
+        } else {
+            frame_state(mem, state->prev)->next = state->next;
+            frame_state(mem, state->next)->prev = state->prev;
+            if (mem->oldest == frame) {
+                mem->oldest = state->next;
+            }
+        }
+    }
+
+    if (mem->n_evicted >= mem->evicted_cap) {
+        mem->evicted_cap *= 2;
+        mem->evicted =
+            realloc(mem->evicted, sizeof(*mem->evicted) * mem->evicted_cap);
+        assert(mem->evicted);
+        STAT_INC(mallocs);
+    }
+    mem->evicted[mem->n_evicted++] = frame;
 
-    return ceil(p->mem_size / (double)FRAME_SIZE);
+    mem->allocatable += mem->frame_size;
+    mem->used -= mem->frame_size;
 }
 
 // Evicts the pages used by a provided process
@@ -433,24 +1210,17 @@ void evict_all_pages(paged_mem_t *mem, process_t *p) {
     }
 
     page_table_t *table = (page_table_t *)p->mem;
-    int first = 1;
     // Free every frame used by the process
-    for (int i = 0; i < table->n_pages; i++) {
+    for (size_t i = 0; i < table->len; i++) {
 
         if (table->pages[i] == -1) {
             continue;
         }
 
-        mem->frames[table->pages[i]] = 0;
-        first ? first = 0 : printf(",");
-        printf("%d", table->pages[i]);
-
-        mem->allocatable += FRAME_SIZE;
-        mem->used -= FRAME_SIZE;
+        evict_frame(mem, table->pages[i]);
     }
 
-    free(table->pages);
-    free(table);
+    page_table_free(mem, table);
     p->mem = NULL;
 
     return;
@@ -458,41 +1228,21 @@ void evict_all_pages(paged_mem_t *mem, process_t *p) {
 
 // Tries to allocate as many pages as possible to the process
 // Returns 0 if unsuccessful, the number of pages allocated otherwise;
-int allocate_pages(paged_mem_t *mem, process_t *p) {
+size_t allocate_pages(paged_mem_t *mem, process_t *p, size_t time) {
     // Not enough pages to allocate
-    if (mem->allocatable < FRAME_SIZE * MIN_PAGES) {
+    if (mem->allocatable < mem->frame_size * mem->min_pages) {
         return 0;
     }
 
-    int to_allocate =
-        MIN(mem->allocatable / FRAME_SIZE, ceil(p->mem_size / FRAME_SIZE));
-
-    // TODO: Fix reallocation to use existing allocated frames
-    if (p->mem) {
-        free(((page_table_t *)p->mem)->pages);
-        free(p->mem);
-    }
-    page_table_t *table = page_table_init(p->mem_size);
-
-    int frame = 0;
-    for (int i = 0; i < to_allocate; i++) {
-        // Should never go past max index since memory is allocatable
-        // Find the next unallocated frame
-        while (mem->frames[frame]) {
-            frame++;
-        }
-
-        // Allocate frame
-        table->pages[i] = frame;
-        mem->frames[frame] = 1;
-        mem->allocatable -= FRAME_SIZE;
-        table->allocated += 1;
+    // Keep the frames the process still holds, only allocating the pages it's
+    // missing
+    if (!p->mem) {
+        p->mem = page_table_init(mem, p);
     }
+    page_table_t *table = (page_table_t *)p->mem;
 
-    mem->used += to_allocate * FRAME_SIZE;
-    p->mem = table;
-
-    return to_allocate;
+    return page_table_fill(mem, table, table->n_pages - table->allocated,
+                           time);
 }
 
 // Evicts enough pages of a process for another process to run
@@ -504,35 +1254,206 @@ void evict_pages(paged_mem_t *mem, process_t *p) {
         return evict_all_pages(mem, p);
     }
 
-    page_table_t *table = (page_table_t *)p->mem;
-    int page = 0;
-    int frame;
-    int first = 1;
+    // Free frames until the minimum pages a process needs are free
+    size_t free_frames = mem->allocatable / mem->frame_size;
+    if (free_frames < mem->min_pages) {
+        evict_some_pages(mem, p->mem, mem->min_pages - free_frames);
+    }
+
+    return;
+}
 
-    while (page < table->n_pages && mem->allocatable < FRAME_SIZE * MIN_PAGES) {
+// Evicts up to n of a page table's allocated pages, lowest pages first
+void evict_some_pages(paged_mem_t *mem, page_table_t *table, size_t n) {
+    size_t page = 0;
+
+    while (page < table->len && n > 0) {
         // Find the next allocated page
-        while (page < table->n_pages && table->pages[page] == -1) {
+        while (page < table->len && table->pages[page] == -1) {
+            STAT_INC(frame_scan_steps);
             page++;
         }
 
-        if (page >= table->n_pages) {
+        if (page >= table->len) {
+            break;
+        }
+
+        evict_page(mem, table, page);
+        n--;
+    }
+}
+
+// Evicts a single allocated page of a page table
+void evict_page(paged_mem_t *mem, page_table_t *table, size_t page) {
+    evict_frame(mem, table->pages[page]);
+    table->pages[page] = -1;
+    table->allocated -= 1;
+    table->hole = MIN(table->hole, page);
+}
+
+// Evicts the pages of the least recently used processes in lru that aren't
+// running until process p can be allocated memory. Virtual memory only
+// evicts enough pages to free the minimum pages a process needs
+// Returns 1 if successful, 0 without evicting anything if not possible
+int evict_lru_pages(paged_mem_t *mem, process_t *p, list_t *lru,
+                    int virtual) {
+    size_t free_frames = mem->allocatable / mem->frame_size;
+    size_t target = virtual ? mem->min_pages
+                            : CEIL_DIV(p->mem_size, mem->frame_size);
+
+    // Plan how far down the lru order eviction has to go
+    node_t *last = NULL;
+    size_t planned = free_frames;
+    for (node_t *node = lru->head; node && planned < target;
+         node = node->next) {
+        STAT_INC(lru_nodes_walked);
+        process_t *victim = (process_t *)node->data;
+        if (victim->running || !victim->mem) {
+            continue;
+        }
+
+        size_t pages = ((page_table_t *)victim->mem)->allocated;
+        planned += virtual ? MIN(pages, target - planned) : pages;
+        last = node;
+    }
+
+    if (planned < target) {
+        // The rest of memory is held by running processes
+        return 0;
+    }
+
+    // Evict every planned victim in one batch
+    for (node_t *node = lru->head; last && node; node = node->next) {
+        STAT_INC(lru_nodes_walked);
+        process_t *victim = (process_t *)node->data;
+        if (!victim->running && victim->mem) {
+            if (virtual) {
+                evict_some_pages(mem, victim->mem,
+                                 target - mem->allocatable / mem->frame_size);
+            } else {
+                evict_all_pages(mem, victim);
+            }
+        }
+
+        if (node == last) {
             break;
         }
+    }
+
+    return 1;
+}
+
+// Returns the number of frames held by the processes in lru that aren't
+// running
+size_t evictable_frames(list_t *lru) {
+    size_t frames = 0;
+    for (node_t *node = lru->head; node; node = node->next) {
+        STAT_INC(lru_nodes_walked);
+        process_t *p = (process_t *)node->data;
+        if (!p->running && p->mem) {
+            frames += ((page_table_t *)p->mem)->allocated;
+        }
+    }
+
+    return frames;
+}
+
+// Returns whether a frame's page can be evicted by a replacement policy
+int frame_evictable(paged_mem_t *mem, long frame) {
+    frame_t *state = frame_state(mem, frame);
+    return state && state->table && !state->table->process->running;
+}
 
-        if (table->pages[page] == -1) {
+// Evicts the page in a frame, or every page of its process if virtual is 0
+void evict_frame_page(paged_mem_t *mem, long frame, int virtual) {
+    frame_t *state = frame_state(mem, frame);
+
+    if (virtual) {
+        evict_page(mem, state->table, state->page);
+    } else {
+        // Paged memory only runs processes with every page allocated
+        evict_all_pages(mem, state->table->process);
+    }
+}
+
+// Evicts unreferenced frames found by a hand sweeping over memory until
+// target frames are free, clearing the references it passes
+void clock_evict(paged_mem_t *mem, size_t target, int virtual) {
+    while (mem->allocatable / mem->frame_size < target) {
+        long frame = mem->hand;
+        mem->hand = (mem->hand + 1) % mem->n_frames;
+        STAT_INC(frame_scan_steps);
+
+        frame_t *state = frame_state(mem, frame);
+        if (!state) {
+            // No frame of the chunk was ever loaded, so skip all of it
+            size_t end = (frame / FRAME_CHUNK + 1) * FRAME_CHUNK;
+            mem->hand = end < mem->n_frames ? end : 0;
+            continue;
+        }
+        if (!frame_evictable(mem, frame)) {
             continue;
         }
 
-        first ? first = 0 : printf(",");
-        printf("%d", table->pages[page]);
+        if (state->referenced) {
+            state->referenced = 0;
+        } else {
+            evict_frame_page(mem, frame, virtual);
+        }
+    }
+}
+
+// Evicts unreferenced frames in the order they were loaded until target
+// frames are free, moving referenced frames to the back of the order
+void second_chance_evict(paged_mem_t *mem, size_t target, int virtual) {
+    while (mem->allocatable / mem->frame_size < target) {
+        long frame = mem->oldest;
+        frame_t *state = frame_state(mem, frame);
+        STAT_INC(frame_scan_steps);
+
+        if (frame_evictable(mem, frame)) {
+            if (!state->referenced) {
+                evict_frame_page(mem, frame, virtual);
+                continue;
+            }
+            state->referenced = 0;
+        }
 
-        frame = table->pages[page];
-        table->pages[page] = -1;
-        mem->frames[frame] = 0;
-        table->allocated -= 1;
-        mem->allocatable += FRAME_SIZE;
-        mem->used -= FRAME_SIZE;
+        // The load order is circular, so making the next frame the oldest
+        // moves this one to the back
+        mem->oldest = state->next;
     }
+}
 
-    return;
-}
\ No newline at end of file
+// Evicts every frame unused for the working set window, then the least
+// recently used frames until target frames are free
+void working_set_evict(paged_mem_t *mem, size_t target, int virtual,
+                       size_t time) {
+    // Frames are kept in the order they were last used, so walk them from
+    // the least recently used, stepping past the ones of running processes
+    long kept = -1;
+    long frame = mem->oldest;
+    while (frame != -1) {
+        frame_t *state = frame_state(mem, frame);
+        STAT_INC(frame_scan_steps);
+
+        int in_working_set = state->last_used + mem->window > time;
+        if (in_working_set && mem->allocatable / mem->frame_size >= target) {
+            break;
+        }
+
+        if (frame_evictable(mem, frame)) {
+            // Paged memory may also evict the frames after this one, with
+            // the rest of its process
+            evict_frame_page(mem, frame, virtual);
+        } else {
+            kept = frame;
+        }
+
+        frame = kept == -1 ? mem->oldest : frame_state(mem, kept)->next;
+        if (kept != -1 && frame == mem->oldest) {
+            // Back at the start, every frame left is running
+            break;
+        }
+    }
+}
@@ -1,15 +1,13 @@
 #ifndef _MEMORY_H_
 #define _MEMORY_H_
 
+#include "bitmap.h"
+#include "blocktree.h"
 #include "config.h"
 #include "linkedlist.h"
 #include "process.h"
 #include <stdlib.h>
 
-#define MAX_MEM 2048
-#define FRAME_SIZE 4
-#define MIN_PAGES 4
-
 // Visible interface for memory management
 
 // Struct defines the memory management type and has an internal pointer to
@@ -19,13 +17,31 @@ typedef struct mem {
     void *data;
 } mem_t;
 
-// Initialises a memory strucuture of the given type
+// Parses a memory option from its command line name
+// Returns 1 if successful, 0 if the name is not a memory option
+int mem_opt_parse(const char *name, mem_opt_t *mem);
+
+// Returns the command line name of a memory option
+const char *mem_opt_name(mem_opt_t mem);
+
+// Returns the most memory a single process can be given by memory of the
+// type and sizes in the run options, SIZE_MAX if there is no such limit
+size_t mem_capacity(run_opts_t *opts);
+
+// Parses a page replacement option from its command line name
+// Returns 1 if successful, 0 if the name is not a replacement option
+int replace_opt_parse(const char *name, replace_opt_t *replace);
+
+// Returns the command line name of a page replacement option
+const char *replace_opt_name(replace_opt_t replace);
+
+// Initialises a memory strucuture of the type and sizes in the run options
 // To be used by a process scheduler
-mem_t *mem_init(mem_opt_t type);
+mem_t *mem_init(run_opts_t *opts);
 
-// Tries to allocate memory to given process
+// Tries to allocate memory to given process at the given time
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int mem_alloc(mem_t *mem, process_t *p);
+size_t mem_alloc(mem_t *mem, process_t *p, size_t time);
 
 // Frees the memory used by a provided process
 void mem_free(mem_t *mem, process_t *p);
@@ -36,6 +52,63 @@ void mem_struct_free(mem_t *mem);
 // Returns the percentage of used memory for the provided mem struct
 int mem_usage(mem_t *mem);
 
+// Returns the amount of memory currently allocated to processes
+size_t mem_used(mem_t *mem);
+
+// Returns the total amount of memory managed by the mem struct
+size_t mem_total(mem_t *mem);
+
+// Returns the address a process's contiguous memory starts at
+size_t mem_allocated_at(mem_t *mem, process_t *p);
+
+// Returns the percentage of allocated memory processes didn't ask for
+int mem_internal_frag(mem_t *mem);
+
+// Returns the percentage of free memory outside the largest free block
+int mem_external_frag(mem_t *mem);
+
+// Returns the size of the largest free block of contiguous or buddy memory,
+// 0 for other memory types
+// A process without memory can be allocated it if and only if it needs no
+// more than this
+size_t mem_largest_free(mem_t *mem);
+
+// Returns the frames evicted since the evicted frames were last cleared, in
+// eviction order, storing how many there are in len
+long *mem_evicted(mem_t *mem, size_t *len);
+
+// Clears the list of evicted frames
+void mem_clear_evicted(mem_t *mem);
+
+// Evicts pages picked by the configured replacement policy at the given time
+// for process p to be allocated memory. lru is a list of the processes
+// holding memory, least recently used first
+// Running processes keep their pages, and nothing is evicted if not enough
+// memory can be freed
+// Returns 1 if p can now be allocated memory, 0 otherwise
+int mem_evict(mem_t *mem, process_t *p, list_t *lru, size_t time);
+
+// Marks every page of a process as used at the given time
+void mem_touch(mem_t *mem, process_t *p, size_t time);
+
+// Returns the number of pages allocated to processes, 0 if memory is not
+// paged
+size_t mem_page_faults(mem_t *mem);
+
+// Returns the number of frames evicted to make room for other processes
+size_t mem_evictions(mem_t *mem);
+
+// Slides every allocated block of contiguous memory down to the lowest
+// addresses, merging the free memory into one block at the end
+// Returns the amount of allocated memory moved, 0 for other memory types
+size_t mem_compact(mem_t *mem);
+
+// Returns the number of times contiguous memory has been compacted
+size_t mem_compactions(mem_t *mem);
+
+// Returns the total amount of memory moved by compacting contiguous memory
+size_t mem_compacted(mem_t *mem);
+
 // Checks whether a process has enough memory to run
 // Returns 1 if the process can run, 0 otherwise
 int mem_check(mem_t *mem, process_t *p);
@@ -46,60 +119,248 @@ int mem_check(mem_t *mem, process_t *p);
 typedef struct mem_block mem_block_t;
 struct mem_block {
     int allocated;
-    int start;
-    int end;
-    int size;
+    size_t start;
+    size_t end;
+    size_t size;
+    node_t *class_node; // Node in its size class's list, segregated fit only
 };
 
-// Contiguous memory is a wrapper struct over a doubly-linked list
-typedef list_t cont_mem_t;
+// Number of size classes, class i holding blocks of 2^i to 2^(i+1) - 1
+#define SIZE_CLASSES (sizeof(size_t) * 8)
 
-// Initialises unallocated contiguous memory of size MAX_MEM
-cont_mem_t *cont_mem_init();
+// Contiguous memory is a doubly-linked list of blocks in address order, with
+// either an address ordered tree indexing the free blocks for first-fit
+// searches or lists of them by size class for segregated fit
+typedef struct cont_mem {
+    list_t *blocks; // Every block, data is a mem_block_t
+    block_tree_t *free; // Every free block, data is the block's list node
+    list_t **classes;   // Free blocks by size class, NULL for first fit
+    size_t used;        // Total size of allocated blocks
+    size_t total;       // Total size of all blocks
+    size_t compactions; // Times memory has been compacted
+    size_t compacted;   // Total size of allocated blocks moved by compacting
+    pool_t *block_pool; // Pool the mem_block_t's are allocated from
+    pool_t *node_pool;  // Pool the block list's nodes are allocated from
+} cont_mem_t;
+
+// Initialises unallocated contiguous memory of the provided size, indexing
+// free blocks by size class if segregated is set
+cont_mem_t *cont_mem_init(size_t size, int segregated);
 
 // Tries to allocate memory to given process using a first-fit policy
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int first_fit(cont_mem_t *mem, process_t *p);
+size_t first_fit(cont_mem_t *mem, process_t *p);
+
+// Tries to allocate memory to given process from the smallest size class
+// with a big enough block
+// Returns 0 if unsuccessful, the amount of memory allocated otherwise
+size_t seg_fit(cont_mem_t *mem, process_t *p);
+
+// Allocates the start of a free block to a given process, leaving the rest
+// of the block free
+// Returns the amount of memory allocated
+size_t allocate_block(cont_mem_t *mem, node_t *node, process_t *p);
+
+// Indexes a free block, given by its list node, for allocation
+void free_index_add(cont_mem_t *mem, node_t *node);
+
+// Removes a free block, given by its list node, from the allocation index
+void free_index_remove(cont_mem_t *mem, node_t *node);
+
+// Returns the size class of a block size
+size_t size_class(size_t size);
+
+// Returns the size of the largest free block
+size_t largest_free_block(cont_mem_t *mem);
 
 // Frees a block memory used by a provided process
 void free_block(cont_mem_t *mem, process_t *p);
 
+// Merges the block after the provided node into it, freeing the later block
+void merge_blocks(cont_mem_t *mem, node_t *node);
+
+// Slides every allocated block down to the lowest addresses, keeping their
+// order, and merges the free memory into one block at the end
+// Processes keep their blocks, only the blocks' addresses change
+// Returns the total size of the allocated blocks that moved
+size_t compact_blocks(cont_mem_t *mem);
+
+// Buddy memory structures and methods definitions
+// -------------------------------
+// -------------------------------------------------------------------------------
+
+// Buddy memory allocates blocks of 2^order, splitting bigger free blocks in
+// halves as needed and merging a freed block with its buddy, the other half
+// it was split from, whenever both are free
+// Memory that isn't a power of two is split into decreasing power of two
+// blocks that are never merged
+typedef struct buddy_mem {
+    block_tree_t **free; // Free blocks of each order, data is a mem_block_t
+    size_t max_order;    // Order of the largest block
+    size_t used;         // Total size of allocated blocks
+    size_t requested;    // Total memory asked for by the allocated processes
+    size_t total;
+    pool_t *block_pool; // Pool the mem_block_t's are allocated from
+} buddy_mem_t;
+
+// Initialises unallocated buddy memory of the provided size
+buddy_mem_t *buddy_mem_init(size_t size);
+
+// Tries to allocate the smallest block of a power of two size to a process
+// Returns 0 if unsuccessful, the amount of memory allocated otherwise
+size_t buddy_alloc(buddy_mem_t *mem, process_t *p);
+
+// Frees the block used by a provided process, merging it with its buddies
+void buddy_free(buddy_mem_t *mem, process_t *p);
+
+// Frees buddy memory and its blocks
+void buddy_mem_free(buddy_mem_t *mem);
+
+// Returns the order of the smallest block that holds the given size
+size_t buddy_order(size_t size);
+
 // Paged memory structures and methods definitions
 // -------------------------------
 // -------------------------------------------------------------------------------
 
+// A process's page table is allocated once and kept while the process lives,
+// growing as more of its pages become resident
+typedef struct page_table {
+    process_t *process;
+    long *pages; // Frame of each page, -1 if the page is not allocated
+    size_t len;  // Entries in pages, pages past them are not allocated
+    size_t cap;
+    size_t n_pages;   // Number of pages the process needs
+    size_t allocated; // Number of pages currently allocated
+    size_t hole;      // No page before this one is unallocated
+} page_table_t;
+
+// What a replacement policy other than LRU knows about a frame
+typedef struct frame {
+    page_table_t *table; // Table of the page in the frame, NULL if it's free
+    size_t page;
+    int referenced;   // Whether the page was used since the policy last looked
+    size_t last_used; // Time the page was last used
+    long prev;        // Frames loaded before and after, or used before and
+    long next;        // after with WORKING_SET replacement
+} frame_t;
+
+// Frames whose replacement state is allocated together, the first time one of
+// them is loaded
+#define FRAME_CHUNK 1024
+
 typedef struct paged_mem {
     size_t allocatable;
     size_t used;
-    int *frames;
-    int n_frames;
+    size_t frame_size;
+    size_t min_pages; // Pages a process needs allocated to run
+    bitmap_t *frames; // Set bits are allocated frames
+    size_t n_frames;
+    pool_t *table_pool; // Pool the page_table_t's are allocated from
+    long *evicted;      // Frames evicted since the list was last cleared
+    size_t n_evicted;
+    size_t evicted_cap;
+    replace_opt_t replace;
+    frame_t **frame_state; // State of each chunk of frames, NULL until one
+                           // of them is loaded. NULL with LRU replacement
+    size_t n_chunks;
+    size_t hand;           // Next frame CLOCK looks at
+    long oldest;           // Oldest loaded frame, or least recently used with
+                           // WORKING_SET. -1 if every frame is free
+    size_t window;        // Time a page stays in a working set after use
+    size_t faults;        // Pages allocated to processes
+    size_t evictions;     // Frames evicted to make room for other processes
 } paged_mem_t;
 
-typedef struct page_table {
-    int *pages;
-    int n_pages;
-    int allocated;
-} page_table_t;
+// Initialises unallocated paged memory of the provided size, split into
+// frames of frame_size, evicting pages with the given replacement policy
+// window is only used by WORKING_SET replacement
+paged_mem_t *paged_mem_init(size_t size, size_t frame_size, size_t min_pages,
+                            replace_opt_t replace, size_t window);
+
+// Initialises a page table that covers the memory of a provided process
+page_table_t *page_table_init(paged_mem_t *mem, process_t *p);
 
-// Initialises unallocated paged memory of size MAX_MEM and frame size
-// FRAME_SIZE
-paged_mem_t *paged_mem_init();
+// Frees a page table, without freeing the frames it holds
+void page_table_free(paged_mem_t *mem, page_table_t *table);
 
-// Initialises a page table that covers a provided size of memory
-page_table_t *page_table_init(size_t mem_size);
+// Allocates up to n of a page table's unallocated pages, lowest pages first
+// Returns the number of pages allocated
+size_t page_table_fill(paged_mem_t *mem, page_table_t *table, size_t n,
+                       size_t time);
+
+// Grows a page table to hold at least len entries
+void page_table_reserve(page_table_t *table, size_t len);
 
 // Tries to allocate memorty to a given process using paged memory
 // Returns 0 if unsuccessful, the amount of memory allocated otherwise
-int fit_pages(paged_mem_t *mem, process_t *p);
+size_t fit_pages(paged_mem_t *mem, process_t *p, size_t time);
+
+// Returns the replacement state of a frame, NULL if no frame of its chunk has
+// been loaded yet
+frame_t *frame_state(paged_mem_t *mem, long frame);
+
+// Returns the replacement state of a frame, allocating the state of its chunk
+// if no frame of it has been loaded yet
+frame_t *frame_state_alloc(paged_mem_t *mem, long frame);
+
+// Frees the replacement state of the frames
+void paged_mem_free_state(paged_mem_t *mem);
+
+// Records a page newly loaded into its frame at the given time for replacement
+void load_frame(paged_mem_t *mem, page_table_t *table, size_t page,
+                size_t time);
+
+// Moves a loaded frame to the back of the order, as the most recently used
+void frame_to_back(paged_mem_t *mem, long frame);
+
+// Frees a frame, recording it in the list of evicted frames
+void evict_frame(paged_mem_t *mem, long frame);
+
+// Evicts a single allocated page of a page table
+void evict_page(paged_mem_t *mem, page_table_t *table, size_t page);
 
 // Evicts the pages used by a provided process
 void evict_all_pages(paged_mem_t *mem, process_t *p);
 
 // Tries to allocate as many pages as possible to the process
 // Returns 0 if unsuccessful, the number of pages allocated otherwise;
-int allocate_pages(paged_mem_t *mem, process_t *p);
+size_t allocate_pages(paged_mem_t *mem, process_t *p, size_t time);
 
 // Evicts enough pages of a process for another process to run
 void evict_pages(paged_mem_t *mem, process_t *p);
 
+// Evicts up to n of a page table's allocated pages, lowest pages first
+void evict_some_pages(paged_mem_t *mem, page_table_t *table, size_t n);
+
+// Evicts the pages of the least recently used processes in lru that aren't
+// running until process p can be allocated memory. Virtual memory only
+// evicts enough pages to free the minimum pages a process needs
+// Returns 1 if successful, 0 without evicting anything if not possible
+int evict_lru_pages(paged_mem_t *mem, process_t *p, list_t *lru,
+                    int virtual);
+
+// Returns the number of frames held by the processes in lru that aren't
+// running
+size_t evictable_frames(list_t *lru);
+
+// Returns whether a frame's page can be evicted by a replacement policy
+int frame_evictable(paged_mem_t *mem, long frame);
+
+// Evicts the page in a frame, or every page of its process if virtual is 0
+void evict_frame_page(paged_mem_t *mem, long frame, int virtual);
+
+// Evicts unreferenced frames found by a hand sweeping over memory until
+// target frames are free, clearing the references it passes
+void clock_evict(paged_mem_t *mem, size_t target, int virtual);
+
+// Evicts unreferenced frames in the order they were loaded until target
+// frames are free, moving referenced frames to the back of the order
+void second_chance_evict(paged_mem_t *mem, size_t target, int virtual);
+
+// Evicts every frame unused for the working set window, then the least
+// recently used frames until target frames are free
+void working_set_evict(paged_mem_t *mem, size_t target, int virtual,
+                       size_t time);
+
 #endif
\ No newline at end of file
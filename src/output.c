@@ -0,0 +1,115 @@
+#include "output.h"
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Makes sure there's room to append n more characters, flushing if needed
+void out_reserve(out_t *out, size_t n);
+
+// Creates and returns a new output writing to file, or discarding everything
+// if file is NULL
+out_t *new_output(FILE *file) {
+    out_t *out = malloc(sizeof(*out));
+    assert(out);
+
+    out->file = file;
+    out->buf = malloc(OUTPUT_BUFFER_SIZE);
+    assert(out->buf);
+    out->len = 0;
+
+    return out;
+}
+
+// Appends a null terminated string
+void out_str(out_t *out, const char *str) {
+    out_bytes(out, str, strlen(str));
+}
+
+// Appends n raw bytes
+void out_bytes(out_t *out, const void *bytes, size_t n) {
+    const char *b = bytes;
+
+    // Long writes are written out in buffer sized pieces
+    while (n > OUTPUT_BUFFER_SIZE - out->len) {
+        size_t part = OUTPUT_BUFFER_SIZE - out->len;
+        memcpy(out->buf + out->len, b, part);
+        out->len += part;
+        out_flush(out);
+        b += part;
+        n -= part;
+    }
+
+    memcpy(out->buf + out->len, b, n);
+    out->len += n;
+}
+
+// Appends a single character
+void out_char(out_t *out, char c) {
+    out_reserve(out, 1);
+    out->buf[out->len++] = c;
+}
+
+// Appends an unsigned integer in decimal
+void out_uint(out_t *out, size_t value) {
+    // Longest 64-bit integer is 20 digits
+    char digits[20];
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    out_reserve(out, n);
+    while (n > 0) {
+        out->buf[out->len++] = digits[--n];
+    }
+}
+
+// Appends a signed integer in decimal
+void out_int(out_t *out, long value) {
+    if (value < 0) {
+        out_char(out, '-');
+        out_uint(out, -(size_t)value);
+    } else {
+        out_uint(out, value);
+    }
+}
+
+// Appends printf style formatted text, at most OUTPUT_MAX_WRITE characters
+void out_printf(out_t *out, const char *format, ...) {
+    out_reserve(out, OUTPUT_MAX_WRITE + 1);
+
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out->buf + out->len, OUTPUT_MAX_WRITE + 1, format, args);
+    va_end(args);
+
+    assert(n >= 0 && n <= OUTPUT_MAX_WRITE);
+    out->len += n;
+}
+
+// Writes everything buffered out to the file
+void out_flush(out_t *out) {
+    if (out->file && out->len > 0) {
+        fwrite(out->buf, 1, out->len, out->file);
+        fflush(out->file);
+    }
+    out->len = 0;
+}
+
+// Flushes and frees the output, leaving the file open
+void out_free(out_t *out) {
+    out_flush(out);
+    free(out->buf);
+    free(out);
+}
+
+// Makes sure there's room to append n more characters, flushing if needed
+void out_reserve(out_t *out, size_t n) {
+    if (out->len + n > OUTPUT_BUFFER_SIZE) {
+        out_flush(out);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef _OUTPUT_H_
+#define _OUTPUT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Size of an output's buffer
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+// Longest single write that can be appended to an output at once
+#define OUTPUT_MAX_WRITE 256
+
+// Struct for a buffered writer of event output
+// Writes are appended to a large buffer that is only written out to the file
+// once it fills up or is flushed
+typedef struct output {
+    FILE *file; // File written to, NULL to discard all output
+    char *buf;
+    size_t len;
+} out_t;
+
+// Creates and returns a new output writing to file, or discarding everything
+// if file is NULL
+out_t *new_output(FILE *file);
+
+// Appends a null terminated string
+void out_str(out_t *out, const char *str);
+
+// Appends n raw bytes
+void out_bytes(out_t *out, const void *bytes, size_t n);
+
+// Appends a single character
+void out_char(out_t *out, char c);
+
+// Appends an unsigned integer in decimal
+void out_uint(out_t *out, size_t value);
+
+// Appends a signed integer in decimal
+void out_int(out_t *out, long value);
+
+// Appends printf style formatted text, at most OUTPUT_MAX_WRITE characters
+void out_printf(out_t *out, const char *format, ...);
+
+// Writes everything buffered out to the file
+void out_flush(out_t *out);
+
+// Flushes and frees the output, leaving the file open
+void out_free(out_t *out);
+
+#endif
@@ -0,0 +1,301 @@
+#include "policy.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN(a, b) (a < b ? a : b)
+#define CEIL_DIV(a, b) ((a + b - 1) / b)
+
+// Command line names of the policy options, indexed by policy_opt_t
+const char *policy_opt_names[] = {"rr", "srtf", "cfs"};
+
+// Operations of each policy, indexed by policy_opt_t
+const policy_ops_t policy_ops[] = {
+    [ROUND_ROBIN] = {rr_policy_enqueue, rr_policy_peek, rr_policy_pick_next,
+                     NULL, rr_policy_quanta_to_preempt, NULL, rr_policy_ready,
+                     rr_policy_free},
+    [SRTF] = {srtf_policy_enqueue, heap_policy_peek, heap_policy_pick_next,
+              NULL, srtf_policy_quanta_to_preempt, NULL, heap_policy_ready,
+              heap_policy_free},
+    [CFS] = {cfs_policy_enqueue, cfs_policy_peek, cfs_policy_pick_next,
+             cfs_policy_tick, cfs_policy_quanta_to_preempt,
+             cfs_policy_on_finish, cfs_policy_ready, cfs_policy_free},
+};
+
+// End of Definitions
+// ------------------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Parses a policy option from its command line name
+// Returns 1 if successful, 0 if the name is not a policy option
+int policy_opt_parse(const char *name, policy_opt_t *policy) {
+    for (size_t i = 0; i < sizeof(policy_opt_names) / sizeof(*policy_opt_names);
+         i++) {
+        if (strcmp(name, policy_opt_names[i]) == 0) {
+            *policy = i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Returns the command line name of a policy option
+const char *policy_opt_name(policy_opt_t policy) {
+    return policy_opt_names[policy];
+}
+
+// Creates and returns a new policy of the given type
+policy_t *new_policy(policy_opt_t type) {
+    policy_t *policy = malloc(sizeof(*policy));
+    assert(policy);
+
+    policy->ops = &policy_ops[type];
+    policy->len = 0;
+
+    switch (type) {
+    case ROUND_ROBIN:
+        policy->data = new_queue();
+        break;
+    case SRTF:
+        policy->data = new_heap();
+        break;
+    case CFS:;
+        cfs_policy_t *cfs = malloc(sizeof(*cfs));
+        assert(cfs);
+        cfs->ready = new_heap();
+        cfs->min_vruntime = 0;
+        policy->data = cfs;
+        break;
+    }
+
+    return policy;
+}
+
+// Places a process in the policy's ready structure
+void policy_enqueue(policy_t *policy, process_t *process) {
+    policy->ops->enqueue(policy, process);
+    policy->len += 1;
+}
+
+// Returns the ready process the policy would run next without removing it
+// Returns NULL if no process is ready
+process_t *policy_peek(policy_t *policy) {
+    if (policy->len < 1) {
+        return NULL;
+    }
+
+    return policy->ops->peek(policy);
+}
+
+// Removes and returns the ready process the policy runs next
+// Returns NULL if no process is ready
+process_t *policy_pick_next(policy_t *policy) {
+    if (policy->len < 1) {
+        return NULL;
+    }
+
+    policy->len -= 1;
+    return policy->ops->pick_next(policy);
+}
+
+// Accounts for the running process having run for the given time
+void policy_tick(policy_t *policy, process_t *running, size_t ran) {
+    if (policy->ops->tick) {
+        policy->ops->tick(policy, running, ran);
+    }
+}
+
+// Returns the number of quanta the running process can run while other
+// processes are ready before the policy could preempt it, assuming no process
+// arrives or finishes in between
+size_t policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                size_t quantum) {
+    return policy->ops->quanta_to_preempt(policy, running, quantum);
+}
+
+// Informs the policy that a process finished
+void policy_on_finish(policy_t *policy, process_t *process) {
+    if (policy->ops->on_finish) {
+        policy->ops->on_finish(policy, process);
+    }
+}
+
+// Writes the ready processes to out in the order the policy would run them,
+// out must have room for every ready process
+void policy_ready(policy_t *policy, process_t **out) {
+    policy->ops->ready(policy, out);
+}
+
+// Frees the policy, leaving the processes it holds untouched
+void policy_free(policy_t *policy) {
+    policy->ops->free(policy);
+    free(policy);
+}
+
+// Round robin policy implementations
+// -----------------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Places a process at the tail of the ready queue
+void rr_policy_enqueue(policy_t *policy, process_t *process) {
+    enqueue(policy->data, process);
+}
+
+// Returns the process at the head of the ready queue
+process_t *rr_policy_peek(policy_t *policy) {
+    return queue_peek(policy->data);
+}
+
+// Removes and returns the process at the head of the ready queue
+process_t *rr_policy_pick_next(policy_t *policy) {
+    return dequeue(policy->data);
+}
+
+// Returns 1, the running process is preempted every quantum
+size_t rr_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                   size_t quantum) {
+    return 1;
+}
+
+// Writes the ready queue to out from head to tail
+void rr_policy_ready(policy_t *policy, process_t **out) {
+    queue_t *ready = policy->data;
+    for (size_t i = 0; i < ready->len; i++) {
+        out[i] = queue_get(ready, i);
+    }
+}
+
+// Frees the ready queue
+void rr_policy_free(policy_t *policy) {
+    queue_free(policy->data, NULL);
+}
+
+// Shortest remaining time first policy implementations
+// ---------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Places a process in the ready heap
+void srtf_policy_enqueue(policy_t *policy, process_t *process) {
+    heap_push(policy->data, process->remaining, process);
+}
+
+// Returns the ready process with the least remaining time
+process_t *heap_policy_peek(policy_t *policy) {
+    return heap_peek(policy->data);
+}
+
+// Removes and returns the ready process with the least remaining time
+process_t *heap_policy_pick_next(policy_t *policy) {
+    return heap_pop(policy->data);
+}
+
+// Returns 1 if a ready process is no longer than the running process, which
+// can only run instead when the shorter processes don't fit in memory
+// Otherwise returns SIZE_MAX, the running process only ever gets shorter than
+// the ready processes, so it is only preempted by arrivals
+size_t srtf_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                     size_t quantum) {
+    // Readied processes go behind ready ones with the same remaining time
+    if (heap_min_key(policy->data) <= running->remaining) {
+        return 1;
+    }
+
+    return SIZE_MAX;
+}
+
+// Writes the ready heap to out in the order it would be popped
+void heap_policy_ready(policy_t *policy, process_t **out) {
+    heap_sorted(policy->data, (void **)out);
+}
+
+// Frees the ready heap
+void heap_policy_free(policy_t *policy) {
+    heap_free(policy->data);
+}
+
+// Completely fair policy implementations
+// -------------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Places a process in the ready heap, no earlier than the least virtual
+// runtime
+void cfs_policy_enqueue(policy_t *policy, process_t *process) {
+    cfs_policy_t *cfs = policy->data;
+
+    if (process->vruntime < cfs->min_vruntime) {
+        process->vruntime = cfs->min_vruntime;
+    }
+    heap_push(cfs->ready, process->vruntime, process);
+}
+
+// Returns the ready process with the least virtual runtime
+process_t *cfs_policy_peek(policy_t *policy) {
+    return heap_peek(((cfs_policy_t *)policy->data)->ready);
+}
+
+// Removes and returns the ready process with the least virtual runtime
+process_t *cfs_policy_pick_next(policy_t *policy) {
+    cfs_policy_t *cfs = policy->data;
+
+    process_t *process = heap_pop(cfs->ready);
+    cfs_update_min(cfs, process);
+
+    return process;
+}
+
+// Adds the time run to the running process's virtual runtime
+void cfs_policy_tick(policy_t *policy, process_t *running, size_t ran) {
+    running->vruntime += ran;
+    cfs_update_min(policy->data, running);
+}
+
+// Returns the number of quanta until the running process's virtual runtime
+// catches up with the least virtual runtime of the ready processes
+size_t cfs_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                    size_t quantum) {
+    cfs_policy_t *cfs = policy->data;
+    size_t min = heap_min_key(cfs->ready);
+
+    // Readied processes go behind ready ones with the same virtual runtime, so
+    // the running process is preempted as soon as it catches up
+    if (running->vruntime >= min) {
+        return 1;
+    }
+
+    return CEIL_DIV(min - running->vruntime, quantum);
+}
+
+// Moves the least virtual runtime past the finished process
+void cfs_policy_on_finish(policy_t *policy, process_t *process) {
+    cfs_update_min(policy->data, NULL);
+}
+
+// Writes the ready heap to out in the order it would be popped
+void cfs_policy_ready(policy_t *policy, process_t **out) {
+    heap_sorted(((cfs_policy_t *)policy->data)->ready, (void **)out);
+}
+
+// Frees the ready heap
+void cfs_policy_free(policy_t *policy) {
+    heap_free(((cfs_policy_t *)policy->data)->ready);
+    free(policy->data);
+}
+
+// Raises the least virtual runtime to that of the running process, if any,
+// and the ready processes
+void cfs_update_min(cfs_policy_t *cfs, process_t *running) {
+    size_t min = SIZE_MAX;
+    if (running) {
+        min = running->vruntime;
+    }
+    if (cfs->ready->len > 0) {
+        min = MIN(min, heap_min_key(cfs->ready));
+    }
+
+    // Never move backwards, so processes can't gain by waiting to be readied
+    if (min != SIZE_MAX && min > cfs->min_vruntime) {
+        cfs->min_vruntime = min;
+    }
+}
@@ -0,0 +1,191 @@
+#ifndef _POLICY_H_
+#define _POLICY_H_
+
+#include "config.h"
+#include "heap.h"
+#include "process.h"
+#include "queue.h"
+#include <stdlib.h>
+
+typedef struct policy policy_t;
+
+// Operations implemented by a scheduling policy
+// tick and on_finish are optional and may be NULL
+typedef struct policy_ops {
+    // Places a process in the policy's ready structure
+    void (*enqueue)(policy_t *policy, process_t *process);
+
+    // Returns the ready process the policy would run next without removing it
+    process_t *(*peek)(policy_t *policy);
+
+    // Removes and returns the ready process the policy runs next
+    process_t *(*pick_next)(policy_t *policy);
+
+    // Accounts for the running process having run for the given time
+    void (*tick)(policy_t *policy, process_t *running, size_t ran);
+
+    // Returns the number of quanta the running process can run while other
+    // processes are ready before the policy could preempt it, assuming no
+    // process arrives or finishes in between
+    size_t (*quanta_to_preempt)(policy_t *policy, process_t *running,
+                                size_t quantum);
+
+    // Informs the policy that a process finished
+    void (*on_finish)(policy_t *policy, process_t *process);
+
+    // Writes the ready processes to out in the order the policy would run
+    // them
+    void (*ready)(policy_t *policy, process_t **out);
+
+    // Frees the policy's ready structure, leaving the processes untouched
+    void (*free)(policy_t *policy);
+} policy_ops_t;
+
+// Struct for a scheduling policy, deciding which ready process runs next
+typedef struct policy {
+    const policy_ops_t *ops;
+    void *data;
+    size_t len; // Number of ready processes
+} policy_t;
+
+// Parses a policy option from its command line name
+// Returns 1 if successful, 0 if the name is not a policy option
+int policy_opt_parse(const char *name, policy_opt_t *policy);
+
+// Returns the command line name of a policy option
+const char *policy_opt_name(policy_opt_t policy);
+
+// Creates and returns a new policy of the given type
+policy_t *new_policy(policy_opt_t type);
+
+// Places a process in the policy's ready structure
+void policy_enqueue(policy_t *policy, process_t *process);
+
+// Returns the ready process the policy would run next without removing it
+// Returns NULL if no process is ready
+process_t *policy_peek(policy_t *policy);
+
+// Removes and returns the ready process the policy runs next
+// Returns NULL if no process is ready
+process_t *policy_pick_next(policy_t *policy);
+
+// Accounts for the running process having run for the given time
+void policy_tick(policy_t *policy, process_t *running, size_t ran);
+
+// Returns the number of quanta the running process can run while other
+// processes are ready before the policy could preempt it, assuming no process
+// arrives or finishes in between
+size_t policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                size_t quantum);
+
+// Informs the policy that a process finished
+void policy_on_finish(policy_t *policy, process_t *process);
+
+// Writes the ready processes to out in the order the policy would run them,
+// out must have room for every ready process
+void policy_ready(policy_t *policy, process_t **out);
+
+// Frees the policy, leaving the processes it holds untouched
+void policy_free(policy_t *policy);
+
+// Round robin policy definitions
+// ---------------------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Ready processes run in arrival order, and a running process is preempted
+// every quantum other processes are ready
+
+// Places a process at the tail of the ready queue
+void rr_policy_enqueue(policy_t *policy, process_t *process);
+
+// Returns the process at the head of the ready queue
+process_t *rr_policy_peek(policy_t *policy);
+
+// Removes and returns the process at the head of the ready queue
+process_t *rr_policy_pick_next(policy_t *policy);
+
+// Returns 1, the running process is preempted every quantum
+size_t rr_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                   size_t quantum);
+
+// Writes the ready queue to out from head to tail
+void rr_policy_ready(policy_t *policy, process_t **out);
+
+// Frees the ready queue
+void rr_policy_free(policy_t *policy);
+
+// Shortest remaining time first policy definitions
+// -------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Ready processes are kept in a heap keyed by remaining time, ties running in
+// the order the processes were readied
+
+// Places a process in the ready heap
+void srtf_policy_enqueue(policy_t *policy, process_t *process);
+
+// Returns the ready process with the least remaining time
+process_t *heap_policy_peek(policy_t *policy);
+
+// Removes and returns the ready process with the least remaining time
+process_t *heap_policy_pick_next(policy_t *policy);
+
+// Returns 1 if a ready process is no longer than the running process, which
+// can only run instead when the shorter processes don't fit in memory
+// Otherwise returns SIZE_MAX, the running process only ever gets shorter than
+// the ready processes, so it is only preempted by arrivals
+size_t srtf_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                     size_t quantum);
+
+// Writes the ready heap to out in the order it would be popped
+void heap_policy_ready(policy_t *policy, process_t **out);
+
+// Frees the ready heap
+void heap_policy_free(policy_t *policy);
+
+// Completely fair policy definitions
+// ---------------------------------------------------------------
+// -------------------------------------------------------------------------------
+
+// Ready processes are kept in a heap keyed by virtual runtime, the time each
+// has run for. Processes start at the least virtual runtime of the processes
+// already running, so newcomers can't monopolise the processor
+
+// Struct to hold the completely fair policy's ready processes
+typedef struct cfs_policy {
+    heap_t *ready;
+    size_t min_vruntime; // Least virtual runtime of any unfinished process
+} cfs_policy_t;
+
+// Places a process in the ready heap, no earlier than the least virtual
+// runtime
+void cfs_policy_enqueue(policy_t *policy, process_t *process);
+
+// Returns the ready process with the least virtual runtime
+process_t *cfs_policy_peek(policy_t *policy);
+
+// Removes and returns the ready process with the least virtual runtime
+process_t *cfs_policy_pick_next(policy_t *policy);
+
+// Adds the time run to the running process's virtual runtime
+void cfs_policy_tick(policy_t *policy, process_t *running, size_t ran);
+
+// Returns the number of quanta until the running process's virtual runtime
+// catches up with the least virtual runtime of the ready processes
+size_t cfs_policy_quanta_to_preempt(policy_t *policy, process_t *running,
+                                    size_t quantum);
+
+// Moves the least virtual runtime past the finished process
+void cfs_policy_on_finish(policy_t *policy, process_t *process);
+
+// Raises the least virtual runtime to that of the running process, if any,
+// and the ready processes
+void cfs_update_min(cfs_policy_t *cfs, process_t *running);
+
+// Writes the ready heap to out in the order it would be popped
+void cfs_policy_ready(policy_t *policy, process_t **out);
+
+// Frees the ready heap
+void cfs_policy_free(policy_t *policy);
+
+#endif
@@ -0,0 +1,88 @@
+#include "pool.h"
+#include "stats.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// Number of objects in a pool's first slab, later slabs double in size
+#define FIRST_SLAB_OBJS 64
+
+// Slabs are aligned to cache lines, so objects the size of a cache line never
+// straddle two
+#define CACHE_LINE 64
+
+// Slabs start with a header linking to the previous slab, padded to a cache
+// line so objects stay aligned
+#define SLAB_HEADER CACHE_LINE
+
+// Allocates a new slab for the pool to carve objects out of
+void pool_grow(pool_t *pool);
+
+// Creates and returns a new empty pool of objects of size obj_size
+pool_t *new_pool(size_t obj_size) {
+    pool_t *pool = malloc(sizeof(*pool));
+    assert(pool);
+
+    // Objects must be able to hold a free list link and stay pointer aligned
+    pool->obj_size =
+        (obj_size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+
+    pool->free_list = NULL;
+    pool->slabs = NULL;
+    pool->next = NULL;
+    pool->end = NULL;
+    pool->slab_objs = FIRST_SLAB_OBJS;
+
+    return pool;
+}
+
+// Allocates an object from the pool
+void *pool_alloc(pool_t *pool) {
+    // Reuse a released object if there is one
+    if (pool->free_list) {
+        void *obj = pool->free_list;
+        pool->free_list = *(void **)obj;
+        return obj;
+    }
+
+    if (pool->next >= pool->end) {
+        pool_grow(pool);
+    }
+
+    void *obj = pool->next;
+    pool->next += pool->obj_size;
+
+    return obj;
+}
+
+// Returns an object to the pool to be reused
+void pool_release(pool_t *pool, void *obj) {
+    *(void **)obj = pool->free_list;
+    pool->free_list = obj;
+}
+
+// Frees the pool and every object allocated from it
+void pool_free(pool_t *pool) {
+    void *slab = pool->slabs;
+    while (slab) {
+        void *prev = *(void **)slab;
+        free(slab);
+        slab = prev;
+    }
+    free(pool);
+}
+
+// Allocates a new slab for the pool to carve objects out of
+void pool_grow(pool_t *pool) {
+    size_t size = SLAB_HEADER + pool->slab_objs * pool->obj_size;
+    char *slab = aligned_alloc(CACHE_LINE,
+                               (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    assert(slab);
+    STAT_INC(mallocs);
+
+    *(void **)slab = pool->slabs;
+    pool->slabs = slab;
+
+    pool->next = slab + SLAB_HEADER;
+    pool->end = pool->next + pool->slab_objs * pool->obj_size;
+    pool->slab_objs *= 2;
+}
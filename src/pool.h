@@ -0,0 +1,31 @@
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <stdlib.h>
+
+// Struct for a pool of fixed size objects
+// Objects are carved out of large slabs and recycled through a free list, so
+// allocating and releasing them never touches the system allocator once the
+// pool has grown large enough. Freeing the pool releases every object at once
+typedef struct pool {
+    size_t obj_size;
+    void *free_list; // Released objects, each storing the next one
+    void *slabs;     // Allocated slabs, each storing the previous one
+    char *next;      // Next never used object in the newest slab
+    char *end;       // End of the newest slab
+    size_t slab_objs; // Number of objects the next slab will hold
+} pool_t;
+
+// Creates and returns a new empty pool of objects of size obj_size
+pool_t *new_pool(size_t obj_size);
+
+// Allocates an object from the pool
+void *pool_alloc(pool_t *pool);
+
+// Returns an object to the pool to be reused
+void pool_release(pool_t *pool, void *obj);
+
+// Frees the pool and every object allocated from it
+void pool_free(pool_t *pool);
+
+#endif
@@ -1,45 +1,129 @@
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "process.h"
 
-#define DELIM " "
+// Skips whitespace and parses an unsigned integer, advancing the cursor
+// past it. Values above UINT32_MAX are returned as UINT32_MAX + 1
+size_t scan_uint(const char **cursor, const char *end);
 
-// Parses and creates a process from a process line
-process_t *parse_process(char *line) {
-    char *delim = DELIM;
-    char *tok;
+// Parses the named field of the process on the line in [line, end) at the
+// cursor, advancing the cursor past it
+// Exits with a parse error if the field doesn't fit in 32 bits
+uint32_t scan_field(const char **cursor, const char *line, const char *end,
+                    const char *field);
 
-    process_t *process = malloc(sizeof(*process));
+// Skips whitespace and copies the following word into dest, advancing the
+// cursor past it. At most max characters are kept, dest is null terminated
+void scan_word(const char **cursor, const char *end, char *dest, size_t max);
+
+// Advances the cursor past any spaces and tabs
+void skip_blanks(const char **cursor, const char *end);
+
+// Parses and creates a process from the line in [line, end), which does not
+// need to be null terminated
+// The process is allocated from pool, or with malloc if pool is NULL
+process_t *parse_process(const char *line, const char *end, pool_t *pool) {
+    process_t *process = pool ? pool_alloc(pool) : malloc(sizeof(*process));
     assert(process);
+    const char *cursor = line;
 
     // Parse process arrival time
-    tok = strtok(line, delim);
-    process->arrived = atoi(tok);
+    process->arrived = scan_field(&cursor, line, end, "arrival time");
 
     // Parse process name
-    tok = strtok(NULL, delim);
-    process->name = strdup(tok);
+    scan_word(&cursor, end, process->name, NAME_MAX_LENGTH);
 
     // Parse process service time and remaining time
-    tok = strtok(NULL, delim);
-    process->service = atoi(tok);
+    process->service = scan_field(&cursor, line, end, "service time");
     process->remaining = process->service;
 
     // Parse process required memory
-    tok = strtok(NULL, delim);
-    process->mem_size = atoi(tok);
+    process->mem_size = scan_field(&cursor, line, end, "memory size");
 
     // No memory to point to yet
     process->mem = NULL;
 
+    // Not in the lru list until it first runs
+    process->lru = NULL;
+    process->id = 0;
+    process->vruntime = 0;
+    process->running = 0;
+
     return process;
 }
 
-// Frees a process and all associated fields
-void process_free(process_t *p) {
-    free(p->name);
-    free(p);
+// Frees a process and all associated fields, returning it to the pool it was
+// allocated from
+void process_free(process_t *p, pool_t *pool) {
+    if (pool) {
+        pool_release(pool, p);
+    } else {
+        free(p);
+    }
+}
+
+// Skips whitespace and parses an unsigned integer, advancing the cursor
+// past it. Values above UINT32_MAX are returned as UINT32_MAX + 1
+size_t scan_uint(const char **cursor, const char *end) {
+    skip_blanks(cursor, end);
+
+    const char *c = *cursor;
+    size_t value = 0;
+    while (c < end && *c >= '0' && *c <= '9') {
+        // Stop growing once out of range, so long values can't wrap around
+        if (value <= UINT32_MAX) {
+            value = value * 10 + (*c - '0');
+        }
+        c++;
+    }
+    if (value > UINT32_MAX) {
+        value = (size_t)UINT32_MAX + 1;
+    }
+
+    *cursor = c;
+    return value;
+}
+
+// Parses the named field of the process on the line in [line, end) at the
+// cursor, advancing the cursor past it
+// Exits with a parse error if the field doesn't fit in 32 bits
+uint32_t scan_field(const char **cursor, const char *line, const char *end,
+                    const char *field) {
+    size_t value = scan_uint(cursor, end);
+    if (value > UINT32_MAX) {
+        fprintf(stderr, "parse error: %s out of range [0, %u] in \"%.*s\"\n",
+                field, UINT32_MAX, (int)(end - line), line);
+        exit(EXIT_FAILURE);
+    }
+
+    return value;
+}
+
+// Skips whitespace and copies the following word into dest, advancing the
+// cursor past it. At most max characters are kept, dest is null terminated
+void scan_word(const char **cursor, const char *end, char *dest, size_t max) {
+    skip_blanks(cursor, end);
+
+    const char *c = *cursor;
+    size_t len = 0;
+    while (c < end && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n') {
+        if (len < max) {
+            dest[len++] = *c;
+        }
+        c++;
+    }
+    dest[len] = '\0';
+
+    *cursor = c;
+}
+
+// Advances the cursor past any spaces and tabs
+void skip_blanks(const char **cursor, const char *end) {
+    while (*cursor < end && (**cursor == ' ' || **cursor == '\t')) {
+        (*cursor)++;
+    }
 }
@@ -3,32 +3,42 @@
 
 typedef struct process process_t;
 
+#include "linkedlist.h"
 #include "memory.h"
+#include "pool.h"
+#include <stdint.h>
 
 // Max length of a process name
 #define NAME_MAX_LENGTH 8
 
-// Max length of line
-// 2^32 numbers are 10 digits
-// Whitespace and new line char are 4 characters
-// Memory is 4 digits
-#define MAX_PROCESS_LINE_LENGTH (10 + NAME_MAX_LENGTH + 10 + 4 + 4)
-
 // Struct to hold all the information relating to a process
+// Times and sizes are read as ints in range [0, 2^32), so they are kept in 32
+// bits, which with the fields ordered by size fits a process in one cache line
+// Processes stay whole structs in pool slabs rather than a struct-of-arrays
+// table with integer handles. The queues, lists and heaps hold process
+// pointers, and a simulated cycle only reads the process running on each core,
+// so splitting the fields into arrays would save no cache misses
 struct process {
-    size_t arrived;   // Time the process arrived, int in range [0, 2^32)
-    char *name;       // Name of the process
-    size_t service;   // Service time of the process, int in range [1, 2^32)
-    size_t remaining; // Remaining time for the process to complete
-    int mem_size;     // Size of the required memory
+    uint32_t arrived;   // Time the process arrived
+    uint32_t service;   // Service time of the process, at least 1
+    uint32_t remaining; // Remaining time for the process to complete
+    uint32_t mem_size;  // Size of the required memory in KB
+    uint32_t id;        // Index of the process in arrival order
+    size_t vruntime;    // Virtual runtime, used by the CFS policy
     void *mem; // Pointer to the allocated memory, type varies depending on
                // memory allocation method
+    node_t *lru; // The process's node in the scheduler's lru list, if any
+    char name[NAME_MAX_LENGTH + 1]; // Name of the process
+    char running; // Whether the process is running on a core
 };
 
-// Parses and creates a process from a process line
-process_t *parse_process(char *line);
+// Parses and creates a process from the line in [line, end), which does not
+// need to be null terminated
+// The process is allocated from pool, or with malloc if pool is NULL
+process_t *parse_process(const char *line, const char *end, pool_t *pool);
 
-// Frees a process and all associated fields
-void process_free(process_t *p);
+// Frees a process and all associated fields, returning it to the pool it was
+// allocated from
+void process_free(process_t *p, pool_t *pool);
 
 #endif
\ No newline at end of file
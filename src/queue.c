@@ -1,86 +1,89 @@
 #include "queue.h"
-#include "linkedlist.h"
+#include "stats.h"
 #include <assert.h>
 #include <stdlib.h>
 
+// Initial number of elements a queue has room for, a power of two
+#define INITIAL_QUEUE_CAP 16
+
+// Index of the element i places from the head of the queue
+#define QUEUE_INDEX(q, i) (((q)->head + (i)) & ((q)->cap - 1))
+
+// Doubles the room in a queue, unwrapping its elements to start the new array
+void queue_grow(queue_t *q);
+
 // Creates and returns a new queue
 queue_t *new_queue() {
-    return (queue_t *)new_list();
+    queue_t *q = malloc(sizeof(*q));
+    assert(q);
+
+    q->head = 0;
+    q->len = 0;
+    q->cap = INITIAL_QUEUE_CAP;
+    q->items = malloc(sizeof(*q->items) * q->cap);
+    assert(q->items);
+
+    return q;
 }
 
 // Deletes and returns the element at the head of the queue
+// Returns NULL if the queue is empty
 void *dequeue(queue_t *queue) {
-    return list_remove_head((list_t *)queue);
+    if (queue->len < 1) {
+        return NULL;
+    }
+
+    void *data = queue->items[queue->head];
+    queue->head = QUEUE_INDEX(queue, 1);
+    queue->len -= 1;
+
+    return data;
 }
 
 // Adds an element to the end of the queue
 void enqueue(queue_t *queue, void *data) {
-    list_add_tail((list_t *)queue, data);
-}
-
-// Places the element at the head of a queue to it's tail
-void requeue_head(queue_t *q) {
-    if (q->len <= 1) {
-        // Queue is empty or only has one element
-        return;
+    if (queue->len >= queue->cap) {
+        queue_grow(queue);
     }
 
-    node_t *node = q->head;
-
-    q->head = q->head->next;
-    q->head->prev = NULL;
-
-    node->prev = q->tail;
-    q->tail->next = node;
-    q->tail = node;
-    q->tail->next = NULL;
+    queue->items[QUEUE_INDEX(queue, queue->len)] = data;
+    queue->len += 1;
 }
 
-// Places a node in the queue at the tail
-void requeue(queue_t *q, node_t *node) {
-    // Node is already at the tail, nothing to do
-    if (q->tail == node) {
-        return;
-    }
-    // Node is at the head, just call requeue_head
-    if (q->head == node) {
-        return requeue_head(q);
-    }
-    node->prev->next = node->next;
-    node->next->prev = node->prev;
+// Returns the element at the head of the queue without removing it
+// Returns NULL if the queue is empty
+void *queue_peek(queue_t *queue) {
+    return queue->len > 0 ? queue->items[queue->head] : NULL;
+}
 
-    node->prev = q->tail;
-    q->tail->next = node;
-    q->tail = node;
-    q->tail->next = NULL;
+// Returns the element i places from the head of the queue, i must be less
+// than the queue's length
+void *queue_get(queue_t *queue, size_t i) {
+    return queue->items[QUEUE_INDEX(queue, i)];
 }
 
-// Removes a node in the queue and returns the data
-void *queue_remove(queue_t *q, node_t *node) {
-    // Node is at the head, just call dequeue;
-    if (q->head == node) {
-        return dequeue(q);
-    }
-    void *data = node->data;
-    q->len -= 1;
-
-    // Node is at the tail, cut it off
-    if (q->tail == node) {
-        q->tail = node->prev;
-        q->tail->next = NULL;
-        free(node);
-        return data;
+// Frees a queue and all data it holds using the provided data_free function,
+// or leaves the data untouched if data_free is NULL
+void queue_free(queue_t *q, void (*data_free)(void *data)) {
+    for (size_t i = 0; data_free && i < q->len; i++) {
+        data_free(queue_get(q, i));
     }
+    free(q->items);
+    free(q);
+}
 
-    node->prev->next = node->next;
-    node->next->prev = node->prev;
+// Doubles the room in a queue, unwrapping its elements to start the new array
+void queue_grow(queue_t *q) {
+    void **items = malloc(sizeof(*items) * q->cap * 2);
+    assert(items);
+    STAT_INC(mallocs);
 
-    free(node);
+    for (size_t i = 0; i < q->len; i++) {
+        items[i] = queue_get(q, i);
+    }
 
-    return data;
+    free(q->items);
+    q->items = items;
+    q->head = 0;
+    q->cap *= 2;
 }
-
-// Frees a queue and all data it holds using the provided data_free function
-void queue_free(queue_t *q, void (*data_free)(void *data)) {
-    list_free((list_t *)q, data_free);
-}
\ No newline at end of file
@@ -1,32 +1,39 @@
 #ifndef _QUEUE_H_
 #define _QUEUE_H_
 
-#include "linkedlist.h"
 #include <stdlib.h>
 
-// Queue is a wrapper class over a doubly-linked list
-// Exposes only certain functionality, as well as extra methods
-typedef list_t queue_t;
+// Queue is a growable ring buffer of elements
+// Elements are stored contiguously, so enqueueing and dequeueing never
+// allocate once the queue has grown large enough. Anything that has to be
+// removed from the middle of a queue belongs in a linked list instead
+typedef struct queue {
+    void **items;
+    size_t head; // Index of the element at the head of the queue
+    size_t len;
+    size_t cap; // Always a power of two
+} queue_t;
 
 // Creates and returns a new queue
 queue_t *new_queue();
 
 // Deletes and returns the element at the head of the queue
+// Returns NULL if the queue is empty
 void *dequeue(queue_t *queue);
 
 // Adds an element to the end of the queue
 void enqueue(queue_t *queue, void *data);
 
-// Places the element at the head of a queue to it's tail
-void requeue_head(queue_t *q);
+// Returns the element at the head of the queue without removing it
+// Returns NULL if the queue is empty
+void *queue_peek(queue_t *queue);
 
-// Places a node in the queue at the tail
-void requeue(queue_t *q, node_t *node);
+// Returns the element i places from the head of the queue, i must be less
+// than the queue's length
+void *queue_get(queue_t *queue, size_t i);
 
-// Removes a node in the queue and returns the data
-void *queue_remove(queue_t *q, node_t *node);
-
-// Frees a queue and all data it holds using the provided data_free function
+// Frees a queue and all data it holds using the provided data_free function,
+// or leaves the data untouched if data_free is NULL
 void queue_free(queue_t *q, void (*data_free)(void *data));
 
-#endif
\ No newline at end of file
+#endif
@@ -1,30 +1,85 @@
 #include <assert.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "checkpoint.h"
+#include "events.h"
 #include "roundrobin.h"
+#include "stats.h"
+#include "trace.h"
 
 #define TWO_DP(x) (round(x * 100.0) / 100.0)
 #define MIN(a, b) (a < b ? a : b)
+#define CEIL_DIV(a, b) ((a + b - 1) / b)
 
 // Simulates only one cycle of the configured scheduler
 void rr_simulate_cycle(rr_t *rr);
 
-// Starts the next process in the scheduler's ready queue
-void rr_start_next(rr_t *rr);
+// Returns the next process to arrive, reading it in if needed
+// Returns NULL if there are no more processes to arrive
+process_t *rr_next_arrival(rr_t *rr);
 
-// Places a process in the scheduler's ready queue
-void rr_ready_process(rr_t *rr, process_t *process);
+// Checks a process read in can ever be given the memory it needs, printing an
+// error and exiting the process with an error if not
+void rr_check_fits(rr_t *rr, process_t *process);
 
-// Fishes a process's execution and prints scheduler statistics
-void rr_finish_process(rr_t *rr);
+// Returns the number of quanta that can be simulated before the next cycle
+// could change the scheduler's state
+size_t rr_quanta_to_next_event(rr_t *rr);
 
-// Evicts all pages used by the least recently used process
-void rr_evict_lru(rr_t *rr);
+// Switches a core to the ready process its policy picks to run next, if any
+void rr_dispatch(rr_t *rr, core_t *core);
 
-// Frees the scheduler and all associated data structures
-void rr_free(rr_t *rr);
+// Removes and returns the core's ready process to run next, as chosen by the
+// policy from the processes that have or can be given the memory they need
+// Returns NULL if none of the core's ready processes can get memory
+process_t *rr_pick_next(rr_t *rr, core_t *core);
+
+// Compacts contiguous memory, if enabled and fragmented enough, when a process
+// of the given size would fit in the free memory but in no free block
+// The other cores stop while memory is copied, taking whole quanta
+// Returns 1 if memory was compacted, 0 otherwise
+int rr_compact(rr_t *rr, size_t size);
+
+// Starts running a process picked from the core's ready processes
+void rr_start(rr_t *rr, core_t *core, process_t *process);
+
+// Places a process in a core's ready queue
+void rr_ready_process(rr_t *rr, core_t *core, process_t *process);
+
+// Returns the core with the fewest processes, running or ready
+core_t *rr_least_loaded(rr_t *rr);
+
+// Returns the number of processes running or ready on a core
+size_t rr_core_load(core_t *core);
+
+// Returns the most loaded core with ready processes to give away
+// Returns NULL if no core has a ready process
+core_t *rr_busiest(rr_t *rr);
+
+// Moves a ready process from one core to another
+void rr_migrate(rr_t *rr, core_t *from, core_t *to);
+
+// Balances the ready processes between cores with the configured balancer
+void rr_balance(rr_t *rr);
+
+// Moves the next periodic balance past the quanta just skipped over, whose
+// balances would have found no ready process to move
+void rr_skip_balances(rr_t *rr);
+
+// Fishes the execution of a core's running process and prints scheduler
+// statistics
+void rr_finish_process(rr_t *rr, core_t *core);
+
+// Evicts pages of processes that aren't running, picked by the configured
+// replacement policy, until the provided process can be allocated memory
+// Returns 1 if successful, 0 if the process still can't be allocated memory
+int rr_evict(rr_t *rr, process_t *process);
+
+// Prints an EVICTED event listing every frame evicted since the last one
+void rr_print_evicted(rr_t *rr);
 
 // Creates and returns a new round-robing scheduler
 // Configures the scheduler according the run_options
@@ -34,16 +89,51 @@ rr_t *new_rr(run_opts_t *opts) {
 
     rr->opts = opts;
     rr->time = 0;
-    rr->running = NULL;
-    rr->ready = new_queue();
+    rr->process_pool = new_pool(sizeof(process_t));
+    rr->node_pool = new_pool(sizeof(node_t));
     rr->processes = new_queue();
+    rr->skipped = new_queue();
+    rr->reader = NULL;
+    rr->reader_ctx = NULL;
     rr->process_count = 0;
     rr->avg_turnaround = 0;
     rr->total_overhead = 0;
     rr->max_overhead = 0;
-    rr->lru = new_queue();
-
-    rr->mem = mem_init(opts->mem);
+    rr->lru = new_pooled_list(rr->node_pool);
+
+    rr->n_cores = opts->cores;
+    rr->cores = malloc(sizeof(*rr->cores) * rr->n_cores);
+    assert(rr->cores);
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        rr->cores[i].id = i;
+        rr->cores[i].running = NULL;
+        rr->cores[i].policy = new_policy(opts->policy);
+        rr->cores[i].busy = 0;
+        rr->cores[i].migrations = 0;
+        rr->cores[i].blocked = 0;
+        rr->cores[i].blocked_largest = 0;
+        rr->cores[i].blocked_smallest = 0;
+    }
+    rr->n_ready = 0;
+    rr->next_balance = BALANCE_PERIOD * opts->quantum;
+
+    rr->mem = mem_init(opts);
+    rr->mem_capacity = mem_capacity(opts);
+    rr->out = new_output(opts->quiet ? NULL : stdout);
+
+    rr->trace = NULL;
+    if (opts->trace_file) {
+        rr->trace = trace_open(opts->trace_file, opts->mem, rr->n_cores);
+        if (!rr->trace) {
+            fprintf(stderr, "allocate: cannot write trace %s\n",
+                    opts->trace_file);
+            exit(EXIT_FAILURE);
+        }
+    }
+    rr->n_arrived = 0;
+    rr->n_read = 0;
+    rr->next_checkpoint = opts->checkpoint_every;
+    stats_reset();
 
     return rr;
 }
@@ -51,210 +141,631 @@ rr_t *new_rr(run_opts_t *opts) {
 // Add's a process to round-scheduler
 // The process will be readied and run when it "arrives"
 void rr_add_process(rr_t *rr, process_t *process) {
+    rr_check_fits(rr, process);
     enqueue(rr->processes, process);
 }
 
-// Simulates the entirety of the configured scheduler
-void rr_simulate(rr_t *rr) {
-    while (rr->running || rr->processes->len > 0) {
+// Streams processes into the scheduler from a reader
+// Each process is only read once simulated time reaches the previous arrival,
+// after any processes added with rr_add_process
+void rr_set_reader(rr_t *rr, rr_reader_t reader, void *ctx) {
+    rr->reader = reader;
+    rr->reader_ctx = ctx;
+
+    // A restored scheduler already holds every process it read before its
+    // checkpoint
+    for (size_t i = 0; i < rr->n_read; i++) {
+        process_t *process = reader(ctx, rr->process_pool);
+        if (!process) {
+            rr->reader = NULL;
+            break;
+        }
+        process_free(process, rr->process_pool);
+    }
+}
+
+// Returns the next process to arrive, reading it in if needed
+// Returns NULL if there are no more processes to arrive
+process_t *rr_next_arrival(rr_t *rr) {
+    if (rr->processes->len < 1 && rr->reader) {
+        process_t *process = rr->reader(rr->reader_ctx, rr->process_pool);
+        if (!process) {
+            // Reader is exhausted
+            rr->reader = NULL;
+            return NULL;
+        }
+        rr_check_fits(rr, process);
+        enqueue(rr->processes, process);
+        rr->n_read += 1;
+    }
+
+    return queue_peek(rr->processes);
+}
+
+// Checks a process read in can ever be given the memory it needs, printing an
+// error and exiting the process with an error if not
+void rr_check_fits(rr_t *rr, process_t *process) {
+    if (process->mem_size <= rr->mem_capacity) {
+        return;
+    }
+
+    // Otherwise it would wait for memory forever
+    out_flush(rr->out);
+    fprintf(stderr,
+            "allocate: process %s needs %zu KB, more than the %zu KB %s "
+            "memory can allocate\n",
+            process->name, (size_t)process->mem_size,
+            rr->mem_capacity, mem_opt_name(rr->opts->mem));
+    exit(EXIT_FAILURE);
+}
+
+// Simulates the entirety of the configured scheduler, then frees it
+// Returns the simulation's summary statistics
+rr_summary_t rr_simulate(rr_t *rr) {
+    for (;;) {
+        int running = 0;
+        for (size_t i = 0; i < rr->n_cores; i++) {
+            running |= rr->cores[i].running != NULL;
+        }
+        if (!running && rr->n_ready < 1 && !rr_next_arrival(rr)) {
+            break;
+        }
+
+        // Checkpoints are only taken between cycles, where the state is
+        // consistent
+        if (rr->opts->checkpoint_file && rr->time >= rr->next_checkpoint) {
+            if (!checkpoint_save(rr, rr->opts->checkpoint_file)) {
+                fprintf(stderr, "allocate: cannot write checkpoint %s\n",
+                        rr->opts->checkpoint_file);
+                exit(EXIT_FAILURE);
+            }
+            rr->next_checkpoint =
+                (rr->time / rr->opts->checkpoint_every + 1) *
+                rr->opts->checkpoint_every;
+        }
+
         rr_simulate_cycle(rr);
     }
 
-    printf("Turnaround time %.0f\n", ceil(rr->avg_turnaround));
-    printf("Time overhead %.2f %.2f\n", TWO_DP(rr->max_overhead),
-           TWO_DP(rr->total_overhead / rr->process_count));
-    printf("Makespan %ld\n", rr->time);
+    rr_summary_t summary;
+    summary.turnaround = ceil(rr->avg_turnaround);
+    summary.max_overhead = TWO_DP(rr->max_overhead);
+    summary.avg_overhead = TWO_DP(rr->total_overhead / rr->process_count);
+    summary.makespan = rr->time;
+
+    print_summary(rr->out, summary.turnaround, summary.max_overhead,
+                  summary.avg_overhead, summary.makespan);
+    if (rr->trace) {
+        trace_summary(rr->trace, summary.turnaround, summary.max_overhead,
+                      summary.avg_overhead, summary.makespan);
+    }
+
+    // Per core statistics only mean something with more than one core
+    for (size_t i = 0; rr->n_cores > 1 && i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        double utilisation =
+            rr->time ? TWO_DP(core->busy * 100.0 / rr->time) : 0;
+
+        print_core_summary(rr->out, core->id, utilisation, core->migrations);
+        if (rr->trace) {
+            trace_core_summary(rr->trace, core->id, utilisation,
+                               core->migrations);
+        }
+    }
+
+    // Paging statistics are only printed when comparing replacement policies
+    if (rr->opts->report_paging &&
+        (rr->opts->mem == PAGED || rr->opts->mem == VIRTUAL)) {
+        print_paging_summary(rr->out, mem_page_faults(rr->mem),
+                             mem_evictions(rr->mem));
+        if (rr->trace) {
+            trace_paging_summary(rr->trace, mem_page_faults(rr->mem),
+                                 mem_evictions(rr->mem));
+        }
+    }
+
+    // As are compaction statistics when measuring what compacting costs
+    if (rr->opts->compact &&
+        (rr->opts->mem == FIRST_FIT || rr->opts->mem == SEG_FIT)) {
+        print_compaction_summary(rr->out, mem_compactions(rr->mem),
+                                 mem_compacted(rr->mem));
+        if (rr->trace) {
+            trace_compaction_summary(rr->trace, mem_compactions(rr->mem),
+                                     mem_compacted(rr->mem));
+        }
+    }
+
+    if (rr->opts->stats) {
+        print_stats(rr->out, &stats, mem_evictions(rr->mem),
+                    mem_page_faults(rr->mem));
+    }
     rr_free(rr);
+
+    return summary;
 }
 
 // Simulates only one cycle of the configured scheduler
 void rr_simulate_cycle(rr_t *rr) {
     // Check if a new process is ready to be added
-    int arrival;
-    do {
-        if (rr->processes->len < 1) {
-            break;
+    process_t *next;
+    while ((next = rr_next_arrival(rr)) && next->arrived <= rr->time) {
+        process_t *arrived = (process_t *)dequeue(rr->processes);
+        arrived->id = rr->n_arrived++;
+        if (rr->trace) {
+            trace_arrival(rr->trace, arrived->id, arrived->name);
         }
-        process_t *next = (process_t *)rr->processes->head->data;
+        rr_ready_process(rr, rr_least_loaded(rr), arrived);
+    }
 
-        arrival = next->arrived;
-        if (arrival <= rr->time) {
-            rr_ready_process(rr, (process_t *)dequeue(rr->processes));
-        }
-    } while (arrival <= rr->time);
-
-    // Check finished process
-    if (rr->running && rr->running->remaining <= 0) {
-        rr_finish_process(rr);
-        if (rr->ready->len < 1 && rr->processes->len < 1) {
-            // No more process to simulate
-            return;
+    // Check finished processes
+    int running = 0;
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        if (core->running && core->running->remaining <= 0) {
+            rr_finish_process(rr, core);
         }
+        running |= core->running != NULL;
+    }
+    if (!running && rr->n_ready < 1 && !next) {
+        // No more process to simulate
+        return;
     }
 
+    rr_balance(rr);
+
     // Check if there's waiting ready processes
-    if (rr->ready->len > 0) {
-        if (rr->running) {
-            rr_ready_process(rr, rr->running);
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        if (rr->cores[i].policy->len > 0) {
+            rr_dispatch(rr, &rr->cores[i]);
         }
+    }
 
-        switch (rr->opts->mem) {
-        case INFINITE:
-            // Run the next ready process
-            rr_start_next(rr);
-            break;
-        case FIRST_FIT:
-            // Find the next process with allocated memory or can allocate
-            // memory
-            while (!mem_check(rr->mem, rr->ready->head->data) &&
-                   !mem_alloc(rr->mem, rr->ready->head->data)) {
-                requeue_head(rr->ready);
+    // Run for as many quanta as can pass before the next event
+    size_t quanta = rr_quanta_to_next_event(rr);
+    rr->time += quanta * rr->opts->quantum;
+    rr_skip_balances(rr);
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        if (core->running) {
+            size_t ran =
+                MIN(core->running->remaining, quanta * rr->opts->quantum);
+            core->running->remaining -= ran;
+            core->busy += ran;
+            policy_tick(core->policy, core->running, ran);
+        }
+    }
+}
+
+// Returns the number of quanta that can be simulated before the next cycle
+// could change the scheduler's state
+size_t rr_quanta_to_next_event(rr_t *rr) {
+    size_t quantum = rr->opts->quantum;
+
+    // Nothing happens until a policy could preempt a running process, a
+    // running process finishes or the next process arrives, whichever is
+    // sooner. All are only noticed on a quantum boundary
+    size_t quanta = SIZE_MAX;
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        if (core->running) {
+            quanta = MIN(quanta, CEIL_DIV(core->running->remaining, quantum));
+            if (core->policy->len > 0) {
+                quanta = MIN(quanta, policy_quanta_to_preempt(
+                                         core->policy, core->running, quantum));
             }
-            rr_start_next(rr);
-            break;
-        case PAGED:
-            if (!mem_check(rr->mem, rr->ready->head->data) &&
-                !mem_alloc(rr->mem, rr->ready->head->data)) {
-                rr_evict_lru(rr);
+        } else if (core->policy->len > 0) {
+            // The core's ready processes are waiting for memory, so try them
+            // again next quantum
+            return 1;
+        }
+    }
+    process_t *next = rr_next_arrival(rr);
+
+    // Compaction can move time past the next arrival or balance, which are
+    // then noticed next quantum
+    if (next) {
+        size_t until = next->arrived > rr->time ? next->arrived - rr->time : 1;
+        quanta = MIN(quanta, CEIL_DIV(until, quantum));
+    }
+    // A balance can only move a ready process, so with none there is no
+    // need to stop for it
+    if (rr->n_cores > 1 && rr->opts->balance == PERIODIC && rr->n_ready > 0) {
+        size_t until =
+            rr->next_balance > rr->time ? rr->next_balance - rr->time : 1;
+        quanta = MIN(quanta, CEIL_DIV(until, quantum));
+    }
+
+    // Always make progress, even with nothing to wait for
+    return quanta > 1 && quanta != SIZE_MAX ? quanta : 1;
+}
+
+// Switches a core to the ready process its policy picks to run next, if any
+void rr_dispatch(rr_t *rr, core_t *core) {
+    STAT_INC(decisions);
+    process_t *prev = core->running;
+    if (core->running) {
+        // The process used its pages up until now
+        mem_touch(rr->mem, core->running, rr->time);
+        rr_ready_process(rr, core, core->running);
+        core->running = NULL;
+    }
+
+    // A process the policy keeps running needs no context switch, but one it
+    // preempted is restarted even if it is the only one that fits in memory
+    int preempted = prev && policy_peek(core->policy) != prev;
+    process_t *process = rr_pick_next(rr, core);
+    if (!process) {
+        // Nothing can run until memory is freed
+        return;
+    }
+
+    if (process == prev && !preempted) {
+        process->running = 1;
+        core->running = process;
+    } else {
+        rr_start(rr, core, process);
+    }
+}
+
+// Removes and returns the core's ready process to run next, as chosen by the
+// policy from the processes that have or can be given the memory they need
+// Returns NULL if none of the core's ready processes can get memory
+process_t *rr_pick_next(rr_t *rr, core_t *core) {
+    process_t *process = NULL;
+    size_t candidates, largest, smallest;
+
+    switch (rr->opts->mem) {
+    case INFINITE:
+        // Run the next ready process
+        process = policy_pick_next(core->policy);
+        break;
+    case FIRST_FIT:
+    case BUDDY:
+    case SEG_FIT:
+        // Going through the ready processes again would find the same,
+        // unless a bigger block has been freed since or compacting memory
+        // makes one
+        largest = mem_largest_free(rr->mem);
+        smallest = core->blocked_smallest;
+        if (core->blocked && largest <= core->blocked_largest) {
+            if (!rr_compact(rr, smallest)) {
+                return NULL;
             }
-            rr_start_next(rr);
-            break;
-        case VIRTUAL:
-            if (!mem_check(rr->mem, rr->ready->head->data) &&
-                !mem_alloc(rr->mem, rr->ready->head->data)) {
-                rr_evict_lru(rr);
+            largest = mem_largest_free(rr->mem);
+        }
+
+        // Rather than passing over the process the policy would run next,
+        // compact memory so it fits
+        process = policy_peek(core->policy);
+        if (process->mem_size > largest && !mem_check(rr->mem, process) &&
+            rr_compact(rr, process->mem_size)) {
+            largest = mem_largest_free(rr->mem);
+        }
+
+        // Find the next process with allocated memory or can allocate
+        // memory, only searching memory for processes that fit in the
+        // largest free block. If none do, compacting memory may make a
+        // block one fits in, which is only worth one more pass as memory
+        // can't be compacted any further
+        for (;;) {
+            smallest = SIZE_MAX;
+            for (candidates = core->policy->len; candidates > 0;
+                 candidates--) {
+                process = policy_pick_next(core->policy);
+                if (mem_check(rr->mem, process) ||
+                    (process->mem_size <= largest &&
+                     mem_alloc(rr->mem, process, rr->time))) {
+                    break;
+                }
+                smallest = MIN(smallest, process->mem_size);
+                enqueue(rr->skipped, process);
+                STAT_INC(skipped);
+                process = NULL;
             }
-            rr_start_next(rr);
-            break;
+
+            // Ready the processes passed over again, after the one picked
+            while (rr->skipped->len > 0) {
+                policy_enqueue(core->policy, dequeue(rr->skipped));
+            }
+            if (process || !rr_compact(rr, smallest)) {
+                break;
+            }
+            largest = mem_largest_free(rr->mem);
+        }
+        core->blocked = process == NULL;
+        core->blocked_largest = largest;
+        core->blocked_smallest = smallest;
+        break;
+    case PAGED:
+    case VIRTUAL:
+        process = policy_peek(core->policy);
+        if (!mem_check(rr->mem, process) &&
+            !mem_alloc(rr->mem, process, rr->time) && !rr_evict(rr, process)) {
+            // The rest of memory is held by processes running on other cores
+            return NULL;
         }
+        process = policy_pick_next(core->policy);
+        break;
     }
 
-    // Run for a quantum
-    rr->time += rr->opts->quantum;
-    if (rr->running) {
-        rr->running->remaining -=
-            MIN(rr->running->remaining, rr->opts->quantum);
+    if (process) {
+        rr->n_ready -= 1;
     }
+    return process;
 }
 
-// Places a process in the scheduler's ready queue
-void rr_ready_process(rr_t *rr, process_t *process) {
-    enqueue(rr->ready, process);
+// Compacts contiguous memory, if enabled and fragmented enough, when a process
+// of the given size would fit in the free memory but in no free block
+// The other cores stop while memory is copied, taking whole quanta
+// Returns 1 if memory was compacted, 0 otherwise
+int rr_compact(rr_t *rr, size_t size) {
+    if (!rr->opts->compact ||
+        (rr->opts->mem != FIRST_FIT && rr->opts->mem != SEG_FIT)) {
+        return 0;
+    }
+
+    size_t free_mem = mem_total(rr->mem) - mem_used(rr->mem);
+    if (size > free_mem || size <= mem_largest_free(rr->mem) ||
+        mem_external_frag(rr->mem) < rr->opts->compact_threshold) {
+        return 0;
+    }
+
+    size_t moved = mem_compact(rr->mem);
+    size_t quantum = rr->opts->quantum, rate = rr->opts->compact_rate;
+    size_t copy_time = CEIL_DIV(CEIL_DIV(moved, rate), quantum) * quantum;
+
+    print_compacted(rr->out, rr->time, moved, copy_time);
+    if (rr->trace) {
+        trace_compacted(rr->trace, rr->time, moved, copy_time);
+    }
+    rr->time += copy_time;
+
+    return 1;
+}
+
+// Places a process in a core's ready queue
+void rr_ready_process(rr_t *rr, core_t *core, process_t *process) {
+    process->running = 0;
+    policy_enqueue(core->policy, process);
+    core->blocked = 0;
+    rr->n_ready += 1;
+}
+
+// Returns the core with the fewest processes, running or ready
+core_t *rr_least_loaded(rr_t *rr) {
+    core_t *least = &rr->cores[0];
+
+    for (size_t i = 1; i < rr->n_cores; i++) {
+        if (rr_core_load(&rr->cores[i]) < rr_core_load(least)) {
+            least = &rr->cores[i];
+        }
+    }
+
+    return least;
+}
+
+// Returns the number of processes running or ready on a core
+size_t rr_core_load(core_t *core) {
+    return core->policy->len + (core->running != NULL);
+}
+
+// Returns the most loaded core with ready processes to give away
+// Returns NULL if no core has a ready process
+core_t *rr_busiest(rr_t *rr) {
+    core_t *busiest = NULL;
+
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        core_t *core = &rr->cores[i];
+        if (core->policy->len > 0 &&
+            (!busiest || rr_core_load(core) > rr_core_load(busiest))) {
+            busiest = core;
+        }
+    }
+
+    return busiest;
 }
 
-// Fishes a process's execution and prints scheduler statistics
-void rr_finish_process(rr_t *rr) {
+// Moves a ready process from one core to another
+void rr_migrate(rr_t *rr, core_t *from, core_t *to) {
+    policy_enqueue(to->policy, policy_pick_next(from->policy));
+    to->blocked = 0;
+    to->migrations += 1;
+}
 
-    node_t *curr = rr->lru->head;
-    while (curr) {
-        if (rr->running == curr->data) {
-            queue_remove(rr->lru, curr);
+// Balances the ready processes between cores with the configured balancer
+void rr_balance(rr_t *rr) {
+    if (rr->n_cores < 2) {
+        return;
+    }
+
+    switch (rr->opts->balance) {
+    case STEAL:
+        // Idle cores take the next process of the most loaded core, unless
+        // that would just leave it idle instead
+        for (size_t i = 0; i < rr->n_cores; i++) {
+            core_t *core = &rr->cores[i];
+            if (rr_core_load(core) > 0) {
+                continue;
+            }
+
+            core_t *busiest = rr_busiest(rr);
+            if (busiest && rr_core_load(busiest) > 1) {
+                rr_migrate(rr, busiest, core);
+            }
+        }
+        break;
+    case PERIODIC:
+        if (rr->time < rr->next_balance) {
             break;
         }
-        curr = curr->next;
+        // Balances skipped over while memory was compacted aren't made up
+        while (rr->next_balance <= rr->time) {
+            rr->next_balance += BALANCE_PERIOD * rr->opts->quantum;
+        }
+
+        // Even out the loads until no core has two more processes than
+        // another
+        for (;;) {
+            core_t *busiest = rr_busiest(rr);
+            core_t *least = rr_least_loaded(rr);
+            if (!busiest ||
+                rr_core_load(busiest) < rr_core_load(least) + 2) {
+                break;
+            }
+            rr_migrate(rr, busiest, least);
+        }
+        break;
     }
+}
 
-    if (rr->opts->mem == PAGED || rr->opts->mem == VIRTUAL) {
-        printf("%ld,EVICTED,evicted-frames=[", rr->time);
+// Moves the next periodic balance past the quanta just skipped over, whose
+// balances would have found no ready process to move
+void rr_skip_balances(rr_t *rr) {
+    if (rr->n_cores < 2 || rr->opts->balance != PERIODIC || rr->n_ready > 0) {
+        return;
+    }
+
+    // The cycle at the last quantum skipped would have left the next balance
+    // after it, so the balance due now, if any, still happens
+    size_t period = BALANCE_PERIOD * rr->opts->quantum;
+    size_t last = rr->time - rr->opts->quantum;
+    if (rr->next_balance <= last) {
+        rr->next_balance += ((last - rr->next_balance) / period + 1) * period;
+    }
+}
+
+// Fishes the execution of a core's running process and prints scheduler
+// statistics
+void rr_finish_process(rr_t *rr, core_t *core) {
+    process_t *process = core->running;
+
+    // Finished processes no longer hold memory to evict
+    if (process->lru) {
+        list_remove(rr->lru, process->lru);
+        process->lru = NULL;
     }
-    mem_free(rr->mem, rr->running);
+
+    mem_free(rr->mem, process);
     if (rr->opts->mem == PAGED || rr->opts->mem == VIRTUAL) {
-        printf("]\n");
+        rr_print_evicted(rr);
     }
 
-    printf("%ld,FINISHED,process-name=%s,proc-remaining=%ld\n", rr->time,
-           rr->running->name, rr->ready->len);
+    print_finished(rr->out, rr->time, process->name, rr->n_ready);
+    if (rr->trace) {
+        trace_finished(rr->trace, rr->time, process->id, rr->n_ready);
+    }
+    policy_on_finish(core->policy, process);
 
-    int turnaround = rr->time - rr->running->arrived;
+    unsigned long turnaround = rr->time - process->arrived;
     rr->process_count += 1;
     rr->avg_turnaround /= rr->process_count;
     rr->avg_turnaround *= rr->process_count - 1;
     rr->avg_turnaround += turnaround / (long double)rr->process_count;
 
-    double overhead = (long double)turnaround / (long double)rr->running->service;
+    double overhead = (long double)turnaround / (long double)process->service;
     rr->total_overhead += overhead;
     rr->max_overhead =
         overhead > rr->max_overhead ? overhead : rr->max_overhead;
 
-    process_free(rr->running);
-    rr->running = NULL;
+    process_free(process, rr->process_pool);
+    core->running = NULL;
 }
 
-// Starts the next process in the scheduler's ready queue
-void rr_start_next(rr_t *rr) {
-    rr->running = dequeue(rr->ready);
-
-    // Navigate through lru queue, find process and requeue
-    // Or add process to lru queue if run for first time
-    node_t *curr = rr->lru->head;
-    int found = 0;
-    while (curr) {
-        if (curr->data == rr->running) {
-            requeue(rr->lru, curr);
-            found = 1;
-            break;
-        }
-        curr = curr->next;
-    }
-    if (!found) {
-        enqueue(rr->lru, rr->running);
+// Starts running a process picked from the core's ready processes
+void rr_start(rr_t *rr, core_t *core, process_t *process) {
+    core->running = process;
+    process->running = 1;
+
+    // Mark the process as most recently used
+    // Or add process to lru list if run for first time
+    if (process->lru) {
+        list_move_tail(rr->lru, process->lru);
+    } else {
+        process->lru = list_add_tail(rr->lru, process);
     }
 
-    printf("%ld,RUNNING,process-name=%s,remaining-time=%ld", rr->time,
-           rr->running->name, rr->running->remaining);
-
-    int first = 1;
+    // Gather the memory details printed for the configured memory type
+    int usage = 0;
+    long allocated_at = 0;
+    int internal_frag = 0, external_frag = 0;
+    long *frames = NULL;
+    size_t n_frames = 0;
     switch (rr->opts->mem) {
     case FIRST_FIT:
-        printf(",mem-usage=%d%%,allocated-at=%d", mem_usage(rr->mem),
-               ((mem_block_t *)((node_t *)rr->running->mem)->data)->start);
+        usage = mem_usage(rr->mem);
+        allocated_at = mem_allocated_at(rr->mem, process);
         break;
-    case PAGED:
-        printf(",mem-usage=%d%%,mem-frames=[", mem_usage(rr->mem));
-        for (int i = 0; i < ((page_table_t *)rr->running->mem)->n_pages; i++) {
-            first ? first = 0 : printf(",");
-            printf("%d", ((page_table_t *)rr->running->mem)->pages[i]);
-        }
-        printf("]");
+    case BUDDY:
+    case SEG_FIT:
+        usage = mem_usage(rr->mem);
+        allocated_at = mem_allocated_at(rr->mem, process);
+        internal_frag = mem_internal_frag(rr->mem);
+        external_frag = mem_external_frag(rr->mem);
         break;
+    case PAGED:
     case VIRTUAL:
-        printf(",mem-usage=%d%%,mem-frames=[", mem_usage(rr->mem));
-        for (int i = 0; i < ((page_table_t *)rr->running->mem)->n_pages; i++) {
-
-            if (((page_table_t *)rr->running->mem)->pages[i] != -1) {
-                first ? first = 0 : printf(",");
-                printf("%d", ((page_table_t *)rr->running->mem)->pages[i]);
-            }
-        }
-        printf("]");
+        usage = mem_usage(rr->mem);
+        frames = ((page_table_t *)process->mem)->pages;
+        n_frames = ((page_table_t *)process->mem)->len;
         break;
     case INFINITE:
         break;
     }
 
-    printf("\n");
+    // Cores are only named when there is more than one
+    long core_id = rr->n_cores > 1 ? (long)core->id : -1;
+    print_running(rr->out, rr->time, process->name, process->remaining,
+                  rr->opts->mem, usage, allocated_at, internal_frag,
+                  external_frag, frames, n_frames, core_id);
+    if (rr->trace) {
+        trace_running(rr->trace, rr->time, process->id, process->remaining,
+                      usage, allocated_at, internal_frag, external_frag,
+                      frames, n_frames, core->id);
+    }
 }
 
-// Evicts all pages used by the least recently used process
-void rr_evict_lru(rr_t *rr) {
-    node_t *curr = rr->lru->head;
+// Evicts pages of processes that aren't running, picked by the configured
+// replacement policy, until the provided process can be allocated memory
+// Returns 1 if successful, 0 if the process still can't be allocated memory
+int rr_evict(rr_t *rr, process_t *process) {
+    if (!mem_evict(rr->mem, process, rr->lru, rr->time)) {
+        return 0;
+    }
+
+    rr_print_evicted(rr);
+    return mem_alloc(rr->mem, process, rr->time) != 0;
+}
 
-    printf("%ld,EVICTED,evicted-frames=[", rr->time);
+// Prints an EVICTED event listing every frame evicted since the last one
+void rr_print_evicted(rr_t *rr) {
+    size_t n;
+    long *frames = mem_evicted(rr->mem, &n);
 
-    do {
-        process_t *lru = (process_t *)curr->data;
-        mem_free(rr->mem, lru);
-        curr = curr->next;
-    } while (!mem_alloc(rr->mem, rr->ready->head->data));
+    print_evicted(rr->out, rr->time, frames, n);
+    if (rr->trace) {
+        trace_evicted(rr->trace, rr->time, frames, n);
+    }
 
-    printf("]\n");
+    mem_clear_evicted(rr->mem);
 }
 
 // Frees the scheduler and all associated data structures
 void rr_free(rr_t *rr) {
-    queue_free(rr->ready, (void *)process_free);
-    queue_free(rr->processes, (void *)process_free);
-    free(rr->lru);
+    // List nodes and processes are freed in bulk with their pools
+    for (size_t i = 0; i < rr->n_cores; i++) {
+        policy_free(rr->cores[i].policy);
+    }
+    free(rr->cores);
+    queue_free(rr->processes, NULL);
+    queue_free(rr->skipped, NULL);
+    list_free(rr->lru, NULL);
     mem_struct_free(rr->mem);
+    out_free(rr->out);
+    if (rr->trace) {
+        trace_close(rr->trace);
+    }
+    pool_free(rr->process_pool);
+    pool_free(rr->node_pool);
     free(rr);
 }
+
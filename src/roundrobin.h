@@ -3,18 +3,60 @@
 
 #include "config.h"
 #include "memory.h"
+#include "output.h"
+#include "policy.h"
 #include "process.h"
 #include "queue.h"
+#include "trace.h"
+
+// Reads the next process to arrive, allocating it from pool
+// Returns NULL once there are no more processes
+typedef process_t *(*rr_reader_t)(void *ctx, pool_t *pool);
+
+// Struct to hold the summary statistics of a finished simulation
+typedef struct rr_summary {
+    double turnaround;   // Average turnaround time, rounded up
+    double max_overhead; // Maximum time overhead, to two decimal places
+    double avg_overhead; // Average time overhead, to two decimal places
+    size_t makespan;
+} rr_summary_t;
+
+// Struct to hold a simulated core's processes and statistics
+typedef struct core {
+    size_t id;
+    process_t *running;
+    policy_t *policy;  // Holds the core's ready processes
+    size_t busy;       // Time spent running processes
+    size_t migrations; // Number of processes moved to the core from others
+    int blocked; // Whether none of the ready processes fit in memory, so none
+                 // will until one is readied or a bigger block is freed
+    size_t blocked_largest;  // Largest free block when they didn't fit
+    size_t blocked_smallest; // Least memory any of them needed
+} core_t;
 
 // Struct to hold round-robin scheduler's required information
+// Which ready process runs each quantum is decided by the configured policy
 typedef struct rr_scheduler {
     run_opts_t *opts;
     unsigned long time;
-    process_t *running;
-    queue_t *ready;
+    core_t *cores;
+    size_t n_cores;
+    size_t n_ready;       // Ready processes across every core
+    size_t next_balance;  // Time of the next periodic migration
+    queue_t *skipped;     // Ready processes passed over for lack of memory
     queue_t *processes;
-    queue_t *lru;
+    rr_reader_t reader; // Source of processes yet to be read, if any
+    void *reader_ctx;
+    list_t *lru; // Processes holding memory, least recently used first
     mem_t *mem;
+    size_t mem_capacity; // Most memory one process can be given
+    out_t *out;     // Where events and statistics are written
+    trace_t *trace; // Binary trace of the events, NULL if not tracing
+    size_t n_arrived; // Number of processes that have arrived so far
+    size_t n_read;    // Number of processes read from the reader so far
+    size_t next_checkpoint; // Time of the next checkpoint, if checkpointing
+    pool_t *process_pool; // Pool the scheduler's processes are allocated from
+    pool_t *node_pool;    // Pool the scheduler's lru nodes are allocated from
     size_t process_count;
     long double avg_turnaround;
     long double total_overhead;
@@ -29,7 +71,16 @@ rr_t *new_rr(run_opts_t *opts);
 // The process will be readied and run when it "arrives"
 void rr_add_process(rr_t *rr, process_t *process);
 
-// Simulates the entirety of the configured scheduler
-void rr_simulate(rr_t *rr);
+// Streams processes into the scheduler from a reader
+// Each process is only read once simulated time reaches the previous arrival,
+// after any processes added with rr_add_process
+void rr_set_reader(rr_t *rr, rr_reader_t reader, void *ctx);
+
+// Simulates the entirety of the configured scheduler, then frees it
+// Returns the simulation's summary statistics
+rr_summary_t rr_simulate(rr_t *rr);
+
+// Frees the scheduler and all associated data structures
+void rr_free(rr_t *rr);
 
 #endif
\ No newline at end of file
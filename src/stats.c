@@ -0,0 +1,29 @@
+#include "stats.h"
+#include <string.h>
+
+_Thread_local stats_t stats;
+
+// Zeroes the current thread's counters
+void stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Prints a block of the counters, along with the evictions and page faults
+// counted by the memory
+void print_stats(out_t *out, stats_t *stats, size_t evictions, size_t faults) {
+    const char *names[] = {"blocks-scanned", "frame-scan-steps",
+                           "lru-nodes-walked", "skipped", "evictions",
+                           "page-faults", "mallocs", "decisions"};
+    size_t values[] = {stats->blocks_scanned,   stats->frame_scan_steps,
+                       stats->lru_nodes_walked, stats->skipped,
+                       evictions,               faults,
+                       stats->mallocs,          stats->decisions};
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(*values); i++) {
+        out_str(out, "Stat ");
+        out_str(out, names[i]);
+        out_char(out, ' ');
+        out_uint(out, values[i]);
+        out_char(out, '\n');
+    }
+}
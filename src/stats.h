@@ -0,0 +1,36 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include "output.h"
+#include <stdlib.h>
+
+// Counters of the work done on the simulator's hot paths
+// Building with NO_STATS defined compiles every counter out
+typedef struct stats {
+    size_t blocks_scanned;   // Free blocks looked at for contiguous memory
+    size_t frame_scan_steps; // Bitmap words and frames looked at for paging
+    size_t lru_nodes_walked; // LRU list nodes walked to pick victims
+    size_t skipped;          // Ready processes passed over for lack of memory
+    size_t mallocs;          // Heap allocations made while simulating
+    size_t decisions;        // Times a core picked what to run next
+} stats_t;
+
+// Counters of the simulation running on the current thread, so parallel
+// sweep simulations don't share them
+extern _Thread_local stats_t stats;
+
+#ifdef NO_STATS
+#define STAT_ADD(counter, n) ((void)0)
+#else
+#define STAT_ADD(counter, n) (stats.counter += (n))
+#endif
+#define STAT_INC(counter) STAT_ADD(counter, 1)
+
+// Zeroes the current thread's counters
+void stats_reset(void);
+
+// Prints a block of the counters, along with the evictions and page faults
+// counted by the memory
+void print_stats(out_t *out, stats_t *stats, size_t evictions, size_t faults);
+
+#endif
@@ -0,0 +1,129 @@
+#include "sweep.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Claims and simulates runs of the sweep until none are left
+// Runs as a worker thread
+void *sweep_worker(void *arg);
+
+// Prints the table of summaries of the finished runs
+void sweep_print(sweep_t *sweep, FILE *out);
+
+// Prints an error message to stderr and exits the process with an error
+void sweep_fail(char *message);
+
+// Simulates the workload once for every combination of the swept options,
+// running simulations in parallel, then prints a table of their summaries
+void sweep_simulate(run_opts_t *opts, workload_t *workload, FILE *out) {
+    sweep_opts_t *values = opts->sweep;
+
+    sweep_t sweep;
+    sweep.workload = workload;
+    sweep.n_runs = values->n_quanta * values->n_mems * values->n_mem_sizes;
+    sweep.next_run = 0;
+    sweep.runs = malloc(sizeof(*sweep.runs) * sweep.n_runs);
+    assert(sweep.runs);
+
+    // Every run is a single quiet simulation with one combination of values
+    size_t i = 0;
+    for (size_t q = 0; q < values->n_quanta; q++) {
+        for (size_t m = 0; m < values->n_mems; m++) {
+            for (size_t s = 0; s < values->n_mem_sizes; s++) {
+                run_opts_t *run = &sweep.runs[i++].opts;
+                *run = *opts;
+                run->quantum = values->quanta[q];
+                run->mem = values->mems[m];
+                run->mem_size = values->mem_sizes[s];
+                run->quiet = 1;
+                run->trace_file = NULL;
+                run->checkpoint_file = NULL;
+                run->restore_file = NULL;
+                run->sweep = NULL;
+            }
+        }
+    }
+
+    // A process no memory can hold would never finish, so check every run
+    // can hold the largest before starting any
+    size_t largest = 0;
+    for (size_t p = 0; p < workload->len; p++) {
+        if (workload->processes[p].mem_size > largest) {
+            largest = workload->processes[p].mem_size;
+        }
+    }
+    for (i = 0; i < sweep.n_runs; i++) {
+        run_opts_t *run = &sweep.runs[i].opts;
+        if (largest > mem_capacity(run)) {
+            fprintf(stderr,
+                    "sweep: a process needs %zu KB, more than %s memory of "
+                    "%zu KB can allocate\n",
+                    largest, mem_opt_name(run->mem), run->mem_size);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    size_t n_threads = values->threads;
+    if (n_threads > sweep.n_runs) {
+        n_threads = sweep.n_runs;
+    }
+
+    pthread_t *threads = malloc(sizeof(*threads) * n_threads);
+    assert(threads);
+    for (size_t t = 0; t < n_threads; t++) {
+        if (pthread_create(&threads[t], NULL, sweep_worker, &sweep) != 0) {
+            sweep_fail("cannot start a simulation thread");
+        }
+    }
+    for (size_t t = 0; t < n_threads; t++) {
+        if (pthread_join(threads[t], NULL) != 0) {
+            sweep_fail("cannot wait for a simulation thread");
+        }
+    }
+    free(threads);
+
+    sweep_print(&sweep, out);
+    free(sweep.runs);
+}
+
+// Claims and simulates runs of the sweep until none are left
+// Runs as a worker thread
+void *sweep_worker(void *arg) {
+    sweep_t *sweep = arg;
+
+    size_t i;
+    while ((i = __atomic_fetch_add(&sweep->next_run, 1, __ATOMIC_RELAXED)) <
+           sweep->n_runs) {
+        sweep_run_t *run = &sweep->runs[i];
+
+        workload_cursor_t cursor = {sweep->workload, 0};
+        rr_t *rr = new_rr(&run->opts);
+        rr_set_reader(rr, (rr_reader_t)workload_next, &cursor);
+        run->summary = rr_simulate(rr);
+    }
+
+    return NULL;
+}
+
+// Prints the table of summaries of the finished runs
+void sweep_print(sweep_t *sweep, FILE *out) {
+    fprintf(out, "%-8s %-10s %12s %12s %13s %13s %12s\n", "quantum",
+            "memory", "memory-KB", "turnaround", "max-overhead",
+            "avg-overhead", "makespan");
+
+    for (size_t i = 0; i < sweep->n_runs; i++) {
+        sweep_run_t *run = &sweep->runs[i];
+        fprintf(out, "%-8d %-10s %12zu %12.0f %13.2f %13.2f %12zu\n",
+                run->opts.quantum, mem_opt_name(run->opts.mem),
+                run->opts.mem_size, run->summary.turnaround,
+                run->summary.max_overhead, run->summary.avg_overhead,
+                run->summary.makespan);
+    }
+}
+
+// Prints an error message to stderr and exits the process with an error
+void sweep_fail(char *message) {
+    fprintf(stderr, "sweep: %s\n", message);
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,27 @@
+#ifndef _SWEEP_H_
+#define _SWEEP_H_
+
+#include "config.h"
+#include "roundrobin.h"
+#include "workload.h"
+#include <stdio.h>
+
+// Struct for one simulation of a parameter sweep
+typedef struct sweep_run {
+    run_opts_t opts;
+    rr_summary_t summary;
+} sweep_run_t;
+
+// Struct for a parameter sweep over a shared workload
+typedef struct sweep {
+    workload_t *workload;
+    sweep_run_t *runs; // One run per combination of swept values
+    size_t n_runs;
+    size_t next_run; // Index of the next run to be claimed by a worker
+} sweep_t;
+
+// Simulates the workload once for every combination of the swept options,
+// running simulations in parallel, then prints a table of their summaries
+void sweep_simulate(run_opts_t *opts, workload_t *workload, FILE *out);
+
+#endif
@@ -0,0 +1,235 @@
+#include "trace.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Zigzag encoding maps signed differences to small unsigned integers
+#define ZIGZAG(x) (((uint64_t)(x) << 1) ^ (uint64_t)((int64_t)(x) >> 63))
+
+// Writes a varint to the trace
+void trace_varint(trace_t *trace, uint64_t value);
+
+// Writes a record's type and time to the trace
+void trace_record(trace_t *trace, trace_record_t type, size_t time);
+
+// Writes a frame list to the trace, skipping unallocated (-1) frames
+void trace_frames(trace_t *trace, long *frames, size_t n_frames);
+
+// Writes a double to the trace
+void trace_double(trace_t *trace, double value);
+
+// Creates a trace file for a simulation using the given memory type and
+// number of cores
+// Returns NULL if the file can't be created
+trace_t *trace_open(char *filename, mem_opt_t mem, size_t n_cores) {
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        return NULL;
+    }
+
+    trace_t *trace = malloc(sizeof(*trace));
+    assert(trace);
+
+    trace->file = file;
+    trace->out = new_output(file);
+    trace->mem = mem;
+    trace->n_cores = n_cores;
+    trace->time = 0;
+
+    out_bytes(trace->out, TRACE_MAGIC, TRACE_MAGIC_LENGTH);
+    out_char(trace->out, mem);
+
+    // Single core traces leave out cores entirely
+    if (n_cores > 1) {
+        out_char(trace->out, TRACE_CORES);
+        trace_varint(trace, n_cores);
+    }
+
+    return trace;
+}
+
+// Records the arrival of a process, introducing the id used to refer to it
+void trace_arrival(trace_t *trace, size_t id, const char *name) {
+    size_t len = strlen(name);
+
+    out_char(trace->out, TRACE_ARRIVAL);
+    trace_varint(trace, id);
+    trace_varint(trace, len);
+    out_bytes(trace->out, name, len);
+}
+
+// Records a RUNNING event on the given core
+void trace_running(trace_t *trace, size_t time, size_t id, size_t remaining,
+                   int usage, long allocated_at, int internal_frag,
+                   int external_frag, long *frames, size_t n_frames,
+                   size_t core) {
+    trace_record(trace, TRACE_RUNNING, time);
+    trace_varint(trace, id);
+    trace_varint(trace, remaining);
+
+    switch (trace->mem) {
+    case FIRST_FIT:
+        trace_varint(trace, usage);
+        trace_varint(trace, allocated_at);
+        break;
+    case BUDDY:
+    case SEG_FIT:
+        trace_varint(trace, usage);
+        trace_varint(trace, allocated_at);
+        trace_varint(trace, internal_frag);
+        trace_varint(trace, external_frag);
+        break;
+    case PAGED:
+    case VIRTUAL:
+        trace_varint(trace, usage);
+        trace_frames(trace, frames, n_frames);
+        break;
+    case INFINITE:
+        break;
+    }
+
+    if (trace->n_cores > 1) {
+        trace_varint(trace, core);
+    }
+}
+
+// Records a FINISHED event
+void trace_finished(trace_t *trace, size_t time, size_t id,
+                    size_t proc_remaining) {
+    trace_record(trace, TRACE_FINISHED, time);
+    trace_varint(trace, id);
+    trace_varint(trace, proc_remaining);
+}
+
+// Records an EVICTED event
+void trace_evicted(trace_t *trace, size_t time, long *frames, size_t n_frames) {
+    trace_record(trace, TRACE_EVICTED, time);
+    trace_frames(trace, frames, n_frames);
+}
+
+// Records a COMPACTED event
+void trace_compacted(trace_t *trace, size_t time, size_t moved,
+                     size_t copy_time) {
+    trace_record(trace, TRACE_COMPACTED, time);
+    trace_varint(trace, moved);
+    trace_varint(trace, copy_time);
+}
+
+// Records the summary statistics of a finished simulation
+void trace_summary(trace_t *trace, double turnaround, double max_overhead,
+                   double avg_overhead, size_t makespan) {
+    trace_record(trace, TRACE_SUMMARY, makespan);
+    trace_double(trace, turnaround);
+    trace_double(trace, max_overhead);
+    trace_double(trace, avg_overhead);
+}
+
+// Records the statistics of one core of a finished simulation
+void trace_core_summary(trace_t *trace, size_t core, double utilisation,
+                        size_t migrations) {
+    out_char(trace->out, TRACE_CORE_SUMMARY);
+    trace_varint(trace, core);
+    trace_varint(trace, migrations);
+    trace_double(trace, utilisation);
+}
+
+// Records the page faults and evictions of a finished simulation
+void trace_paging_summary(trace_t *trace, size_t faults, size_t evictions) {
+    out_char(trace->out, TRACE_PAGING);
+    trace_varint(trace, faults);
+    trace_varint(trace, evictions);
+}
+
+// Records the compactions of a finished simulation and the memory they moved
+void trace_compaction_summary(trace_t *trace, size_t compactions,
+                              size_t moved) {
+    out_char(trace->out, TRACE_COMPACTION);
+    trace_varint(trace, compactions);
+    trace_varint(trace, moved);
+}
+
+// Flushes and closes the trace file
+void trace_close(trace_t *trace) {
+    out_free(trace->out);
+    fclose(trace->file);
+    free(trace);
+}
+
+// Encodes value as a varint into buf
+// Returns the number of bytes used
+size_t varint_encode(uint8_t *buf, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        buf[n++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    buf[n++] = value;
+
+    return n;
+}
+
+// Decodes a varint at *cursor, advancing the cursor past it
+// Returns 0 and sets *cursor to NULL if the varint runs past end
+uint64_t varint_decode(const uint8_t **cursor, const uint8_t *end) {
+    const uint8_t *c = *cursor;
+    uint64_t value = 0;
+    int shift = 0;
+
+    while (c < end && shift < 64) {
+        uint8_t byte = *c++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *cursor = c;
+            return value;
+        }
+        shift += 7;
+    }
+
+    *cursor = NULL;
+    return 0;
+}
+
+// Writes a varint to the trace
+void trace_varint(trace_t *trace, uint64_t value) {
+    uint8_t buf[TRACE_MAX_VARINT];
+    out_bytes(trace->out, buf, varint_encode(buf, value));
+}
+
+// Writes a record's type and time to the trace
+void trace_record(trace_t *trace, trace_record_t type, size_t time) {
+    out_char(trace->out, type);
+    trace_varint(trace, time - trace->time);
+    trace->time = time;
+}
+
+// Writes a frame list to the trace, skipping unallocated (-1) frames
+void trace_frames(trace_t *trace, long *frames, size_t n_frames) {
+    size_t count = 0;
+    for (size_t i = 0; i < n_frames; i++) {
+        count += frames[i] != -1;
+    }
+    trace_varint(trace, count);
+
+    int64_t prev = 0;
+    for (size_t i = 0; i < n_frames; i++) {
+        if (frames[i] == -1) {
+            continue;
+        }
+        trace_varint(trace, ZIGZAG(frames[i] - prev));
+        prev = frames[i];
+    }
+}
+
+// Writes a double to the trace
+void trace_double(trace_t *trace, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint8_t buf[sizeof(bits)];
+    for (size_t i = 0; i < sizeof(bits); i++) {
+        buf[i] = bits >> (8 * i);
+    }
+    out_bytes(trace->out, buf, sizeof(buf));
+}
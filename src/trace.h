@@ -0,0 +1,115 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include "config.h"
+#include "output.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+// Binary event trace format
+// -------------------------------------------------------------------------
+// A trace starts with TRACE_MAGIC followed by one byte holding the mem_opt_t
+// the simulation ran with. Then follows a sequence of records, each starting
+// with a one byte trace_record_t. Integers are unsigned LEB128 varints, times
+// are stored as the difference from the previous record's time and frame
+// lists are a count followed by zigzag encoded differences between frames.
+// Simulations of more than one core start with a TRACE_CORES record
+//
+// TRACE_ARRIVAL:      id, name length, name bytes
+// TRACE_RUNNING:      time, id, remaining
+//                     FIRST_FIT adds usage and allocated-at
+//                     BUDDY and SEG_FIT add usage, allocated-at, internal
+//                     and external fragmentation
+//                     PAGED and VIRTUAL add usage and a frame list
+//                     With more than one core, ends with the core
+// TRACE_FINISHED:     time, id, proc-remaining
+// TRACE_EVICTED:      time, frame list
+// TRACE_SUMMARY:      time, then turnaround, max overhead and average
+//                     overhead as 8 byte little endian doubles
+// TRACE_CORES:        number of cores
+// TRACE_CORE_SUMMARY: core, migrations, then utilisation as a double
+// TRACE_PAGING:       page faults, evictions
+// TRACE_COMPACTED:    time, memory moved, copy time
+// TRACE_COMPACTION:   compactions, memory moved
+
+#define TRACE_MAGIC "RRTRACE1"
+#define TRACE_MAGIC_LENGTH 8
+
+// Longest encoding of a 64-bit varint
+#define TRACE_MAX_VARINT 10
+
+// Types of records in a trace
+typedef enum trace_record {
+    TRACE_ARRIVAL = 1,
+    TRACE_RUNNING,
+    TRACE_FINISHED,
+    TRACE_EVICTED,
+    TRACE_SUMMARY,
+    TRACE_CORES,
+    TRACE_CORE_SUMMARY,
+    TRACE_PAGING,
+    TRACE_COMPACTED,
+    TRACE_COMPACTION,
+} trace_record_t;
+
+// Struct for writing a binary event trace
+typedef struct trace {
+    FILE *file;
+    out_t *out;
+    mem_opt_t mem;
+    size_t n_cores;
+    size_t time; // Time of the last record written
+} trace_t;
+
+// Creates a trace file for a simulation using the given memory type and
+// number of cores
+// Returns NULL if the file can't be created
+trace_t *trace_open(char *filename, mem_opt_t mem, size_t n_cores);
+
+// Records the arrival of a process, introducing the id used to refer to it
+void trace_arrival(trace_t *trace, size_t id, const char *name);
+
+// Records a RUNNING event on the given core
+void trace_running(trace_t *trace, size_t time, size_t id, size_t remaining,
+                   int usage, long allocated_at, int internal_frag,
+                   int external_frag, long *frames, size_t n_frames,
+                   size_t core);
+
+// Records a FINISHED event
+void trace_finished(trace_t *trace, size_t time, size_t id,
+                    size_t proc_remaining);
+
+// Records an EVICTED event
+void trace_evicted(trace_t *trace, size_t time, long *frames, size_t n_frames);
+
+// Records a COMPACTED event
+void trace_compacted(trace_t *trace, size_t time, size_t moved,
+                     size_t copy_time);
+
+// Records the summary statistics of a finished simulation
+void trace_summary(trace_t *trace, double turnaround, double max_overhead,
+                   double avg_overhead, size_t makespan);
+
+// Records the statistics of one core of a finished simulation
+void trace_core_summary(trace_t *trace, size_t core, double utilisation,
+                        size_t migrations);
+
+// Records the page faults and evictions of a finished simulation
+void trace_paging_summary(trace_t *trace, size_t faults, size_t evictions);
+
+// Records the compactions of a finished simulation and the memory they moved
+void trace_compaction_summary(trace_t *trace, size_t compactions,
+                              size_t moved);
+
+// Flushes and closes the trace file
+void trace_close(trace_t *trace);
+
+// Encodes value as a varint into buf
+// Returns the number of bytes used
+size_t varint_encode(uint8_t *buf, uint64_t value);
+
+// Decodes a varint at *cursor, advancing the cursor past it
+// Returns 0 and sets *cursor to NULL if the varint runs past end
+uint64_t varint_decode(const uint8_t **cursor, const uint8_t *end);
+
+#endif
@@ -0,0 +1,55 @@
+#include "workload.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of processes a workload initially has room for
+#define INITIAL_CAP 1024
+
+// Reads every process from the loader into a new workload
+workload_t *workload_load(loader_t *loader) {
+    workload_t *workload = malloc(sizeof(*workload));
+    assert(workload);
+
+    workload->len = 0;
+    workload->cap = INITIAL_CAP;
+    workload->processes = malloc(sizeof(*workload->processes) * workload->cap);
+    assert(workload->processes);
+
+    process_t *process;
+    while ((process = loader_next(loader, NULL)) != NULL) {
+        if (workload->len >= workload->cap) {
+            workload->cap *= 2;
+            workload->processes =
+                realloc(workload->processes,
+                        sizeof(*workload->processes) * workload->cap);
+            assert(workload->processes);
+        }
+
+        workload->processes[workload->len++] = *process;
+        process_free(process, NULL);
+    }
+
+    return workload;
+}
+
+// Copies the next process of the workload into a process allocated from pool
+// Returns NULL once every process has been handed out
+// Matches rr_reader_t so a cursor can feed a scheduler
+process_t *workload_next(workload_cursor_t *cursor, pool_t *pool) {
+    if (cursor->next >= cursor->workload->len) {
+        return NULL;
+    }
+
+    process_t *process = pool ? pool_alloc(pool) : malloc(sizeof(*process));
+    assert(process);
+    *process = cursor->workload->processes[cursor->next++];
+
+    return process;
+}
+
+// Frees the workload and all of its processes
+void workload_free(workload_t *workload) {
+    free(workload->processes);
+    free(workload);
+}
@@ -0,0 +1,35 @@
+#ifndef _WORKLOAD_H_
+#define _WORKLOAD_H_
+
+#include "loader.h"
+#include "pool.h"
+#include "process.h"
+#include <stdlib.h>
+
+// Struct for a fully loaded process file
+// Once loaded a workload is only read, so many simulations can replay it at
+// once
+typedef struct workload {
+    process_t *processes; // Processes in arrival order
+    size_t len;
+    size_t cap;
+} workload_t;
+
+// Struct for one simulation's position in a shared workload
+typedef struct workload_cursor {
+    workload_t *workload;
+    size_t next; // Index of the next process to hand out
+} workload_cursor_t;
+
+// Reads every process from the loader into a new workload
+workload_t *workload_load(loader_t *loader);
+
+// Copies the next process of the workload into a process allocated from pool
+// Returns NULL once every process has been handed out
+// Matches rr_reader_t so a cursor can feed a scheduler
+process_t *workload_next(workload_cursor_t *cursor, pool_t *pool);
+
+// Frees the workload and all of its processes
+void workload_free(workload_t *workload);
+
+#endif